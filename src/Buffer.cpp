@@ -90,6 +90,10 @@ void Buffer::sendToController(ChannelPacket *busPacket){
 }
 
 bool Buffer::sendPiece(SenderType t, int type, uint64_t die, uint64_t plane){
+    return sendPiece(t, type, die, plane, NV_PAGE_SIZE*8);
+}
+
+bool Buffer::sendPiece(SenderType t, int type, uint64_t die, uint64_t plane, uint64_t size){
     if(t == CONTROLLER)
     {
       if(IN_BUFFER_SIZE == 0 || inDataSize[die] <= (IN_BUFFER_SIZE-(CHANNEL_WIDTH)))
@@ -129,11 +133,11 @@ bool Buffer::sendPiece(SenderType t, int type, uint64_t die, uint64_t plane){
 	if(OUT_BUFFER_SIZE == 0 || outDataSize[die] <= (OUT_BUFFER_SIZE-DEVICE_WIDTH))
 	{
 	    if(!outData[die].empty() && outData[die].back()->type == type && outData[die].back()->plane == plane &&
-	       outData[die].back()->number < (NV_PAGE_SIZE*8)){
+	       outData[die].back()->number < outData[die].back()->size){
 		outData[die].back()->number = outData[die].back()->number + DEVICE_WIDTH;
 		outDataSize[die] = outDataSize[die] + DEVICE_WIDTH;
 		// if ths was the last piece of this packet, tell the die
-		if( outData[die].back()->number >= (NV_PAGE_SIZE*8))
+		if( outData[die].back()->number >= outData[die].back()->size)
 		{
 		    dies[die]->bufferLoaded();
 		}
@@ -142,8 +146,14 @@ bool Buffer::sendPiece(SenderType t, int type, uint64_t die, uint64_t plane){
 		myPacket->type = type;
 		myPacket->number = DEVICE_WIDTH;
 		myPacket->plane = plane;
+		myPacket->size = size;
 		outData[die].push_back(myPacket);
 		outDataSize[die] = outDataSize[die] + DEVICE_WIDTH;
+		// a partial read can fit in a single piece
+		if(myPacket->number >= myPacket->size)
+		{
+		    dies[die]->bufferLoaded();
+		}
 	    }
 	    return true;
 	}
@@ -296,7 +306,7 @@ void Buffer::update(void){
 		prepareOutChannel(i);
 	    }
 	    // waiting to send data until we have a whole page to send
-	    else if(!CUT_THROUGH && outData[i].front()->number >= (NV_PAGE_SIZE*8))
+	    else if(!CUT_THROUGH && outData[i].front()->number >= outData[i].front()->size)
 	    {
 		prepareOutChannel(i);
 	    }
@@ -309,15 +319,15 @@ void Buffer::prepareOutChannel(uint64_t die)
     // see if we have control of the channel
     if (channel->hasChannel(BUFFER, id) && sendingDie == die && sendingPlane == outData[die].front()->plane)
     {
-	if((outData[die].front()->number >= (((NV_PAGE_SIZE*8)-outDataLeft[die])+CHANNEL_WIDTH)) ||
-	   (outData[die].front()->number >= (NV_PAGE_SIZE*8)))
+	if((outData[die].front()->number >= ((outData[die].front()->size-outDataLeft[die])+CHANNEL_WIDTH)) ||
+	   (outData[die].front()->number >= outData[die].front()->size))
 	{
 	    processOutData(die);
 	}
     }
     // if we don't have the channel, get it
     else if (channel->obtainChannel(id, BUFFER, NULL)){
-	outDataLeft[die] = (NV_PAGE_SIZE*8);
+	outDataLeft[die] = outData[die].front()->size;
 	sendingDie = die;
 	sendingPlane = outData[die].front()->plane;
 	processOutData(die);
@@ -368,9 +378,7 @@ void Buffer::processInData(uint64_t die){
     {
 	//cout << dies[die]->isDieBusy(inData[die].front()->plane) << "\n";
 	//cout << inData[die].front()->type << "\n";
-	if(dies[die]->isDieBusy(inData[die].front()->plane) == 0 ||
-	   (inData[die].front()->type == 5 && dies[die]->isDieBusy(inData[die].front()->plane) == 2) ||
-	   (inData[die].front()->type != 5 && dies[die]->isDieBusy(inData[die].front()->plane) == 3))
+	if(dies[die]->planeReady(inData[die].front()->plane, (ChannelPacketType)inData[die].front()->type))
 	{   
 	    channel->bufferDone(id, die, inData[die].front()->plane);
 	    if(!CUT_THROUGH)
@@ -443,9 +451,9 @@ void Buffer::processOutData(uint64_t die){
     {
 	    if(!CUT_THROUGH)
 	    {
-		     if( outDataSize[die] >= (divide_params((NV_PAGE_SIZE*8), CHANNEL_WIDTH)*CHANNEL_WIDTH))
+		     if( outDataSize[die] >= (divide_params(outData[die].front()->size, CHANNEL_WIDTH)*CHANNEL_WIDTH))
 		     {
-			     outDataSize[die] = outDataSize[die] - (divide_params((NV_PAGE_SIZE*8), CHANNEL_WIDTH)*CHANNEL_WIDTH);
+			     outDataSize[die] = outDataSize[die] - (divide_params(outData[die].front()->size, CHANNEL_WIDTH)*CHANNEL_WIDTH);
 		     }
 		     else
 		     {
@@ -52,6 +52,8 @@ namespace NVDSim{
 	    void sendToController(ChannelPacket *busPacket);
 
 	    bool sendPiece(SenderType t, int type, uint64_t die, uint64_t plane);
+	    // size is the number of bits in the whole transfer, only matters for data coming off of a die
+	    bool sendPiece(SenderType t, int type, uint64_t die, uint64_t plane, uint64_t size);
 	    bool isFull(SenderType t, ChannelPacketType bt, uint64_t die);
 	    
 	    void update(void);
@@ -77,11 +79,14 @@ namespace NVDSim{
 		uint64_t number;
 		// plane that this page is for
 		uint64_t plane;
+		// how many bits there are in total, less than a page for a partial read
+		uint64_t size;
 
 		BufferPacket(){
 		    type = 0;
 		    number = 0;
 		    plane = 0;
+		    size = NV_PAGE_SIZE*8;
 		}
 	    };
 	    
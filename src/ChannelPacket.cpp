@@ -51,9 +51,29 @@ ChannelPacket::ChannelPacket(ChannelPacketType packtype, uint64_t virtualAddr, u
 	plane = plane_num;
 	die = die_num;
 	package = package_num;
+	timeAdded = 0;
+	deadline = 0;
+	tenant = 0;
+	hostTimeAdded = 0;
+	origin = HOST_ORIGIN;
+	offset = 0;
+	size = 0;
+	cache_generation = 0;
+	nextPlane = NULL;
 }
 
-ChannelPacket::ChannelPacket() {}
+ChannelPacket::ChannelPacket() 
+{
+	timeAdded = 0;
+	deadline = 0;
+	tenant = 0;
+	hostTimeAdded = 0;
+	origin = HOST_ORIGIN;
+	offset = 0;
+	size = 0;
+	cache_generation = 0;
+	nextPlane = NULL;
+}
 
 void ChannelPacket::print(uint64_t currentClockCycle){
 	if (this == NULL)
@@ -63,6 +83,24 @@ void ChannelPacket::print(uint64_t currentClockCycle){
 			plane<<" block: "<<block<<" page: "<<page<<" data: "<<data);
 }
 
+uint64_t ChannelPacket::transferSize(void) const
+{
+	return transferSize(offset, size);
+}
+
+// whole sectors from the one the read starts in to the one it ends in, never past the end of the page
+uint64_t ChannelPacket::transferSize(uint64_t offset, uint64_t size)
+{
+	if (!PARTIAL_READS || size == 0)
+	{
+		return NV_PAGE_SIZE;
+	}
+	uint64_t first = offset - (offset % SECTOR_SIZE);
+	uint64_t end = min(offset + size, NV_PAGE_SIZE);
+	end = min(((end + SECTOR_SIZE - 1) / SECTOR_SIZE) * SECTOR_SIZE, NV_PAGE_SIZE);
+	return end - first;
+}
+
 void ChannelPacket::printData(const void *data) 
 {
 	if (data == NULL) 
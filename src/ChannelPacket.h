@@ -53,6 +53,17 @@ namespace NVDSim
 		FAST_WRITE
 	};
 
+	// who asked for a transaction, only the host's own transactions get callbacks
+	// lives here rather than with the transactions so the packets can carry it too
+	enum TransactionOrigin
+	{
+		HOST_ORIGIN,
+		WRITE_BUFFER_ORIGIN,
+		PREFETCH_ORIGIN,
+		SECTOR_PACK_ORIGIN, // host sectors the ftl packed into one page, see SECTOR_MAPPING
+		MAP_ORIGIN // a page of the ftl's own mapping table, see DFTL
+	};
+
 	class ChannelPacket
 	{
 	public:
@@ -67,6 +78,15 @@ namespace NVDSim
 		uint64_t virtualAddress;
 		uint64_t physicalAddress;
 		void *data;
+		uint64_t timeAdded; // controller cycle the packet entered the controller queues
+		uint64_t deadline; // copied from the transaction, 0 for no deadline
+		uint64_t tenant; // copied from the transaction
+		uint64_t hostTimeAdded; // cycle the host handed the transaction to the nvdimm
+		TransactionOrigin origin; // copied from the transaction
+		uint64_t offset; // copied from the transaction
+		uint64_t size; // copied from the transaction
+		uint64_t cache_generation; // copied from the transaction
+		ChannelPacket *nextPlane; // the rest of a multi-plane command, NULL for a normal one
 
 		//Functions
 		ChannelPacket(ChannelPacketType packtype, uint64_t virtualAddr, uint64_t physicalAddr, uint64_t page, 
@@ -76,6 +96,9 @@ namespace NVDSim
 		//void print();
 		void print(uint64_t currentClockCycle);
 		static void printData(const void *data);
+		// bytes of the page that have to come off of the die for this read
+		uint64_t transferSize(void) const;
+		static uint64_t transferSize(uint64_t offset, uint64_t size);
 	};
 }
 
@@ -53,6 +53,9 @@ Controller::Controller(NVDIMM* parent, Logger* l){
 
 	pendingPackets = vector<list <ChannelPacket *> >(NUM_PACKAGES, list<ChannelPacket *>());
 
+	ready_dies = vector<vector<uint64_t> >(NUM_PACKAGES, vector<uint64_t>((DIES_PER_PACKAGE + 63) / 64, 0));
+	write_draining = vector<vector<bool> >(NUM_PACKAGES, vector<bool>(DIES_PER_PACKAGE, false));
+
 	paused = new bool [NUM_PACKAGES];
 	die_pointers = new uint64_t [NUM_PACKAGES];
 	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
@@ -63,6 +66,7 @@ Controller::Controller(NVDIMM* parent, Logger* l){
 
 	done = 0;
 	die_counter = 0;
+	die_start = 0;
 	currentClockCycle = 0;
 }
 
@@ -75,23 +79,15 @@ void Controller::attachFrontBuffer(FrontBuffer *fb){
 }
 
 void Controller::returnReadData(const FlashTransaction  &trans){
-	if(parentNVDIMM->ReturnReadData!=NULL){
-	    (*parentNVDIMM->ReturnReadData)(parentNVDIMM->systemID, trans.address, currentClockCycle, true);
-	}
-	parentNVDIMM->numReads++;
+	parentNVDIMM->readDone(trans, currentClockCycle, true);
 }
 
 void Controller::returnUnmappedData(const FlashTransaction  &trans){
-	if(parentNVDIMM->ReturnReadData!=NULL){
-	    (*parentNVDIMM->ReturnReadData)(parentNVDIMM->systemID, trans.address, currentClockCycle, false);
-	}
-	parentNVDIMM->numReads++;
+	parentNVDIMM->readDone(trans, currentClockCycle, false);
 }
 
 void Controller::returnCritLine(ChannelPacket *busPacket){
-	if(parentNVDIMM->CriticalLineDone!=NULL){
-	    (*parentNVDIMM->CriticalLineDone)(parentNVDIMM->systemID, busPacket->virtualAddress, currentClockCycle, true);
-	}
+	parentNVDIMM->critLineDone(busPacket->virtualAddress, currentClockCycle);
 }
 
 void Controller::returnPowerData(vector<double> idle_energy, vector<double> access_energy, vector<double> erase_energy,
@@ -162,7 +158,11 @@ void Controller::receiveFromChannel(ChannelPacket *busPacket){
 	switch (busPacket->busPacketType)
 	{
 		case READ:
-			returnTransaction.push_back(FlashTransaction(RETURN_DATA, busPacket->virtualAddress, busPacket->data));
+			if(LOGGING && PARTIAL_READS)
+			{
+				log->read_transfer(busPacket->transferSize());
+			}
+			returnTransaction.push_back(FlashTransaction(RETURN_DATA, busPacket));
 			break;
 		case GC_READ:
 			// Nothing to do.
@@ -177,6 +177,18 @@ void Controller::receiveFromChannel(ChannelPacket *busPacket){
 	delete busPacket;
 }
 
+// whether this die's write queue goes ahead of its read queue
+bool Controller::writeNeeded(uint64_t package, uint64_t die)
+{
+    if(ADAPTIVE_WRITE_DRAIN)
+    {
+	uint64_t capacity = CTRL_WRITE_QUEUE_LENGTH != 0 ? CTRL_WRITE_QUEUE_LENGTH : CTRL_WRITE_QUEUE_LIMIT;
+	write_draining[package][die] = parentNVDIMM->writeDrain->drain(write_draining[package][die], writeQueues[package][die].size(), capacity);
+	return write_draining[package][die];
+    }
+    return CTRL_WRITE_ON_QUEUE_SIZE == true && writeQueues[package][die].size() >= CTRL_WRITE_QUEUE_LIMIT;
+}
+
 // this is only called on a write as the name suggests
 bool Controller::checkQueueWrite(ChannelPacket *p)
 {
@@ -197,6 +209,10 @@ bool Controller::checkQueueWrite(ChannelPacket *p)
 }
 
 bool Controller::addPacket(ChannelPacket *p){
+    // the age cap on out of order scheduling counts from here
+    p->timeAdded = currentClockCycle;
+    wakeDie(p->package, p->die);
+
     if(CTRL_SCHEDULE)
     {
 	// If there is not room in the command queue for this packet, then return false.
@@ -232,9 +248,7 @@ bool Controller::addPacket(ChannelPacket *p){
 				 log->access_stop((*it)->virtualAddress, (*it)->physicalAddress);
 			     }
 			     //call write callback
-			     if (parentNVDIMM->WriteDataDone != NULL){
-				 (*parentNVDIMM->WriteDataDone)(parentNVDIMM->systemID, (*it)->virtualAddress, currentClockCycle,true);
-			     }
+			     parentNVDIMM->writeDone(*it, currentClockCycle);
 			     writeQueues[(*it)->package][(*it)->die].erase(it, it++);
 			     break;
 			 }
@@ -305,24 +319,284 @@ bool Controller::addPacket(ChannelPacket *p){
     }
 }
 
+// pick the packet to send next from one of the die queues
+// in order this is always the front, out of order it is the oldest packet in the window whose plane can take it
+// a packet is skipped if anything older in the queue is headed for the same plane so each plane still sees its packets in order
+list<ChannelPacket *>::iterator Controller::selectPacket(list<ChannelPacket *> &queue)
+{
+    list<ChannelPacket *>::iterator chosen = queue.begin();
+
+    if (DEADLINE_SCHEDULE && queue.size() > 1)
+    {
+	chosen = earliestDeadline(queue);
+    }
+
+    // the front has waited long enough, stop letting younger packets go around it
+    if (chosen == queue.begin() && CTRL_OUT_OF_ORDER && queue.size() > 1 &&
+	(CTRL_OOO_AGE_CAP == 0 || currentClockCycle - queue.front()->timeAdded < CTRL_OOO_AGE_CAP))
+    {
+	plane_scratch.assign(PLANES_PER_DIE, false);
+	uint64_t scanned = 0;
+	list<ChannelPacket *>::iterator it;
+	for (it = queue.begin(); it != queue.end() && scanned < CTRL_OOO_WINDOW; it++, scanned++)
+	{
+	    if (!plane_scratch[(*it)->plane])
+	    {
+		if ((*packages)[(*it)->package].dies[(*it)->die]->planeReady(*it))
+		{
+		    chosen = it;
+		    break;
+		}
+		plane_scratch[(*it)->plane] = true;
+	    }
+	}
+	// if nothing in the window can go, the front will just fail to get the channel like it would in order
+    }
+
+    if (MULTI_PLANE && chosen != queue.end())
+    {
+	chosen = multiPlaneData(queue, chosen);
+    }
+    return chosen;
+}
+
+// the ready packet with the closest deadline, or the front if nothing with a deadline can go
+// like out of order only the oldest packet for each plane is a candidate
+list<ChannelPacket *>::iterator Controller::earliestDeadline(list<ChannelPacket *> &queue)
+{
+    list<ChannelPacket *>::iterator best = queue.end(), it;
+    plane_scratch.assign(PLANES_PER_DIE, false);
+    for (it = queue.begin(); it != queue.end(); it++)
+    {
+	if (plane_scratch[(*it)->plane])
+	{
+	    continue;
+	}
+	plane_scratch[(*it)->plane] = true;
+	if ((*it)->deadline != 0 && (best == queue.end() || (*it)->deadline < (*best)->deadline) &&
+	    (*packages)[(*it)->package].dies[(*it)->die]->planeReady(*it))
+	{
+	    best = it;
+	}
+    }
+    if (best == queue.end())
+    {
+	return queue.begin();
+    }
+    return best;
+}
+
+// a write can only take along writes for other planes whose data is already sitting in their cache reg
+// so if a write to the same page on another plane is waiting behind its data, send that data first
+list<ChannelPacket *>::iterator Controller::multiPlaneData(list<ChannelPacket *> &queue, list<ChannelPacket *>::iterator lead)
+{
+    if ((*lead)->busPacketType != WRITE && (*lead)->busPacketType != GC_WRITE)
+    {
+	return lead;
+    }
+
+    Die *die = (*packages)[(*lead)->package].dies[(*lead)->die];
+    plane_scratch.assign(PLANES_PER_DIE, false);
+    plane_scratch[(*lead)->plane] = true;
+
+    list<ChannelPacket *>::iterator it, command;
+    for (it = queue.begin(); it != queue.end(); it++)
+    {
+	uint64_t plane = (*it)->plane;
+	if (plane_scratch[plane])
+	{
+	    continue;
+	}
+	// only the oldest packet for each plane is a candidate
+	plane_scratch[plane] = true;
+
+	if ((*it)->busPacketType == DATA && die->planeReady(*it))
+	{
+	    command = it;
+	    command++;
+	    if (command != queue.end() && (*command)->plane == plane && (*command)->busPacketType == (*lead)->busPacketType &&
+		(*command)->page == (*lead)->page)
+	    {
+		return it;
+	    }
+	}
+    }
+    return lead;
+}
+
+// fold any commands of the same kind for the same page on the other planes of the die into the one going out
+// the die starts the whole chain at once so they share one command transfer and one array time
+void Controller::mergePlanes(list<ChannelPacket *> &queue, ChannelPacket *lead)
+{
+    ChannelPacketType type = lead->busPacketType;
+    if (type == DATA || type == FAST_WRITE)
+    {
+	return;
+    }
+
+    Die *die = (*packages)[lead->package].dies[lead->die];
+    plane_scratch.assign(PLANES_PER_DIE, false);
+    plane_scratch[lead->plane] = true;
+
+    ChannelPacket *tail = lead;
+    uint64_t planes = 1;
+    list<ChannelPacket *>::iterator it = queue.begin();
+    while (it != queue.end())
+    {
+	ChannelPacket *p = *it;
+	if (plane_scratch[p->plane])
+	{
+	    it++;
+	    continue;
+	}
+	plane_scratch[p->plane] = true;
+
+	bool ready;
+	if (type == WRITE || type == GC_WRITE)
+	{
+	    // the data for this write has to be loaded already
+	    ready = (die->isDieBusy(p->plane) == 3);
+	}
+	else
+	{
+	    ready = die->planeReady(p);
+	}
+
+	if (p->busPacketType == type && p->page == lead->page && ready)
+	{
+	    tail->nextPlane = p;
+	    tail = p;
+	    planes++;
+	    it = queue.erase(it);
+	}
+	else
+	{
+	    it++;
+	}
+    }
+
+    if (LOGGING && planes > 1)
+    {
+	log->multi_plane_op(planes);
+    }
+}
+
 // just cleaning up some of the code
 // this was repeated half a dozen times in the code below
+// moves on to the next die that might be able to go, skipping the ones that are asleep counts as trying them
 bool Controller::nextDie(uint64_t package)
 {
-    die_pointers[package]++;
-    if (die_pointers[package] >= DIES_PER_PACKAGE)
+    uint64_t die = die_pointers[package];
+    // nothing is queued for this die so there is no point trying it again until something is
+    if (readQueues[package][die].empty() && writeQueues[package][die].empty())
     {
-	die_pointers[package] = 0;
+	ready_dies[package][die / 64] &= ~(1ULL << (die % 64));
     }
-    die_counter++;
+
+    uint64_t next = firstReadyDie(package, (die + 1) % DIES_PER_PACKAGE);
+    if (next == DIES_PER_PACKAGE)
+    {
+	die_counter = DIES_PER_PACKAGE;
+    }
+    else
+    {
+	// coming back around to this die means all of the others were skipped
+	uint64_t skipped = (next + DIES_PER_PACKAGE - die) % DIES_PER_PACKAGE;
+	die_counter += (skipped == 0) ? DIES_PER_PACKAGE : skipped;
+	die_pointers[package] = next;
+    }
+
     // if we loop the number of dies, then we're done
     if (die_counter >= DIES_PER_PACKAGE)
+    {
+	// nothing went so leave the round robin where it was
+	die_pointers[package] = die_start;
+	return 1;
+    }
+    return 0;
+}
+
+// start the round robin search for a package at the first die that might be able to go
+// returns true if there is nothing worth trying
+bool Controller::firstDie(uint64_t package)
+{
+    die_counter = 0;
+    die_start = die_pointers[package];
+    // something is already going out on this channel so none of the dies can have it
+    if (outgoingPackets[package] != NULL)
+    {
+	return 1;
+    }
+    uint64_t first = firstReadyDie(package, die_start);
+    if (first == DIES_PER_PACKAGE)
     {
 	return 1;
     }
+    die_counter = (first + DIES_PER_PACKAGE - die_start) % DIES_PER_PACKAGE;
+    die_pointers[package] = first;
     return 0;
 }
 
+// same as above but the die just failed to take the packet it was offered
+// without a buffer that can be because the die isn't ready for it, in which case it sleeps until it changes state
+bool Controller::nextDie(uint64_t package, ChannelPacket *tried)
+{
+    if (!BUFFERED && !(*packages)[package].dies[tried->die]->planeReady(tried))
+    {
+	ready_dies[package][tried->die / 64] &= ~(1ULL << (tried->die % 64));
+    }
+    return nextDie(package);
+}
+
+// called when a packet is queued for a die or the die finishes or starts something
+void Controller::wakeDie(uint64_t package, uint64_t die)
+{
+    ready_dies[package][die / 64] |= 1ULL << (die % 64);
+}
+
+// index of the lowest set bit, word can't be 0
+static uint64_t lowest_set_bit(uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    uint64_t bit = 0;
+    while ((word & 1) == 0)
+    {
+	word >>= 1;
+	bit++;
+    }
+    return bit;
+#endif
+}
+
+// find-first-set over a package's ready dies starting at start and wrapping around
+// returns DIES_PER_PACKAGE if none of them are awake
+uint64_t Controller::firstReadyDie(uint64_t package, uint64_t start)
+{
+    vector<uint64_t> &bits = ready_dies[package];
+    uint64_t words = bits.size();
+    // the word start is in only counts from start the first time around and only up to start the second time
+    for (uint64_t n = 0; n <= words; n++)
+    {
+	uint64_t w = (start / 64 + n) % words;
+	uint64_t word = bits[w];
+	if (n == 0)
+	{
+	    word &= ~0ULL << (start % 64);
+	}
+	else if (n == words)
+	{
+	    word &= ~(~0ULL << (start % 64));
+	}
+	if (word != 0)
+	{
+	    return w * 64 + lowest_set_bit(word);
+	}
+    }
+    return DIES_PER_PACKAGE;
+}
+
 void Controller::update(void){
     // schedule the next operation for each die
     if(CTRL_SCHEDULE)
@@ -333,25 +607,32 @@ void Controller::update(void){
 	for (i = 0; i < NUM_PACKAGES; i++)
 	{
 	    // loop through the dies per package to find the packet
-	    die_counter = 0;
-	    done = 0;
+	    done = firstDie(i);
 	    while (!done)
 	    {
 		// do we need to issue a write
 		// *** NOTE: We need to review this write condition for out new design ***
-		if((CTRL_WRITE_ON_QUEUE_SIZE == true && writeQueues[i][die_pointers[i]].size() >= CTRL_WRITE_QUEUE_LIMIT)) //||
+		if(writeNeeded(i, die_pointers[i])) //||
 		    //(CTRL_WRITE_ON_QUEUE_SIZE == false && writeQueues[i][die_pointers[i]].size() >= CTRL_WRITE_QUEUE_LENGTH-1))
 		{
 		    if (!writeQueues[i][die_pointers[i]].empty() && outgoingPackets[i]==NULL){
+			list<ChannelPacket *>::iterator next = selectPacket(writeQueues[i][die_pointers[i]]);
 			//if we can get the channel
-			if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, writeQueues[i][die_pointers[i]].front())){
-			    outgoingPackets[i] = writeQueues[i][die_pointers[i]].front();
+			if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, *next)){
+			    outgoingPackets[i] = *next;
 			    if(LOGGING && QUEUE_EVENT_LOG)
 			    {
-				log->log_ctrl_queue_event(true, writeQueues[i][die_pointers[i]].front()->package, &writeQueues[i][die_pointers[i]]);
+				log->log_ctrl_queue_event(true, (*next)->package, &writeQueues[i][die_pointers[i]]);
+			    }
+			    writeQueues[i][die_pointers[i]].erase(next);
+			    if (MULTI_PLANE)
+			    {
+			        mergePlanes(writeQueues[i][die_pointers[i]], outgoingPackets[i]);
+			    }
+			    if(parentNVDIMM->ftl_waiting)
+			    {
+			        parentNVDIMM->queuesNotFull();
 			    }
-			    writeQueues[i][die_pointers[i]].pop_front();
-			    parentNVDIMM->queuesNotFull();
 			    
 			    switch (outgoingPackets[i]->busPacketType){
 			    case DATA:
@@ -374,7 +655,7 @@ void Controller::update(void){
 			// if we can't get the channel for that die, try the next die			
 			else
 			{
-			    done = nextDie(i);
+			    done = nextDie(i, *next);
 			}
 		    }
 		    // this queue is empty, move on
@@ -423,9 +704,12 @@ void Controller::update(void){
 				log->access_stop(readQueues[i][die_pointers[i]].front()->virtualAddress, readQueues[i][die_pointers[i]].front()->virtualAddress);
 			    }
 			    
-			    returnReadData(FlashTransaction(RETURN_DATA, readQueues[i][die_pointers[i]].front()->virtualAddress, readQueues[i][die_pointers[i]].front()->data));
+			    returnReadData(FlashTransaction(RETURN_DATA, readQueues[i][die_pointers[i]].front()));
 			    readQueues[i][die_pointers[i]].pop_front();
-			    parentNVDIMM->queuesNotFull();
+			    if(parentNVDIMM->ftl_waiting)
+			    {
+			        parentNVDIMM->queuesNotFull();
+			    }
 			    // managed to place something so we're done with this channel
 			    // advance the die pointer since this die is now busy
 			    die_pointers[i]++;
@@ -438,15 +722,23 @@ void Controller::update(void){
 		    }
 		    else if(!write_queue_handled)
 		    {
+			list<ChannelPacket *>::iterator next = selectPacket(readQueues[i][die_pointers[i]]);
 			//if we can get the channel
-			if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, readQueues[i][die_pointers[i]].front())){
-			    outgoingPackets[i] = readQueues[i][die_pointers[i]].front();
+			if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, *next)){
+			    outgoingPackets[i] = *next;
 			    if(LOGGING && QUEUE_EVENT_LOG)
 			    {
-				log->log_ctrl_queue_event(false, readQueues[i][die_pointers[i]].front()->package, &readQueues[i][die_pointers[i]]);
+				log->log_ctrl_queue_event(false, (*next)->package, &readQueues[i][die_pointers[i]]);
+			    }
+			    readQueues[i][die_pointers[i]].erase(next);
+			    if (MULTI_PLANE)
+			    {
+			        mergePlanes(readQueues[i][die_pointers[i]], outgoingPackets[i]);
+			    }
+			    if(parentNVDIMM->ftl_waiting)
+			    {
+			        parentNVDIMM->queuesNotFull();
 			    }
-			    readQueues[i][die_pointers[i]].pop_front();
-			    parentNVDIMM->queuesNotFull();
 			    
 			    channelBeatsLeft[i] = divide_params(COMMAND_LENGTH,CHANNEL_WIDTH);
 			    // managed to place something so we're done with this channel
@@ -461,27 +753,35 @@ void Controller::update(void){
 			// couldn't get the channel so go to the next die
 			else
 			{
-			    done = nextDie(i);
+			    done = nextDie(i, *next);
 			}
 		    }
 		}
 		// if there are no reads to send see if we're allowed to send a write instead
 		else if (CTRL_IDLE_WRITE == true && !writeQueues[i][die_pointers[i]].empty() && outgoingPackets[i]==NULL){
+		    list<ChannelPacket *>::iterator next = selectPacket(writeQueues[i][die_pointers[i]]);
 		    //if we can get the channel
-		    if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, writeQueues[i][die_pointers[i]].front())){
-			outgoingPackets[i] = writeQueues[i][die_pointers[i]].front();
+		    if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, *next)){
+			outgoingPackets[i] = *next;
 			if(LOGGING && QUEUE_EVENT_LOG)
 			{
-			    log->log_ctrl_queue_event(true, writeQueues[i][die_pointers[i]].front()->package, &writeQueues[i][die_pointers[i]]);
+			    log->log_ctrl_queue_event(true, (*next)->package, &writeQueues[i][die_pointers[i]]);
+			}
+			writeQueues[i][die_pointers[i]].erase(next);
+			if (MULTI_PLANE)
+			{
+			    mergePlanes(writeQueues[i][die_pointers[i]], outgoingPackets[i]);
 			}
-			writeQueues[i][die_pointers[i]].pop_front();
 			// successfully issued the write so increment the die pointer
 			die_pointers[i]++;
 			if (die_pointers[i] >= DIES_PER_PACKAGE)
 			{
 			    die_pointers[i] = 0;
 			}
-			parentNVDIMM->queuesNotFull();
+			if(parentNVDIMM->ftl_waiting)
+			{
+			    parentNVDIMM->queuesNotFull();
+			}
 			
 			switch (outgoingPackets[i]->busPacketType){
 			case DATA:
@@ -504,7 +804,7 @@ void Controller::update(void){
 		    // couldn't get the channel so go to the next die
 		    else
 		    {
-			done = nextDie(i);
+			done = nextDie(i, *next);
 		    }
 		}
 		// queue was empty, move on
@@ -522,34 +822,41 @@ void Controller::update(void){
 	//Look through queues and send oldest packets to the appropriate channel
 	for (i = 0; i < NUM_PACKAGES; i++){
 	    // loop through the dies per package to find the packet
-	    die_counter = 0;
-	    done = 0;
+	    done = firstDie(i);
 	    while (!done)
 	    {
 		if (!readQueues[i][die_pointers[i]].empty() && outgoingPackets[i]==NULL){
+		    list<ChannelPacket *>::iterator next = selectPacket(readQueues[i][die_pointers[i]]);
 		    //if we can get the channel
-		    if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, readQueues[i][die_pointers[i]].front())){
-			outgoingPackets[i] = readQueues[i][die_pointers[i]].front();
+		    if ((*packages)[i].channel->obtainChannel(0, CONTROLLER, *next)){
+			outgoingPackets[i] = *next;
 			if(LOGGING && QUEUE_EVENT_LOG)
 			{
-			    switch (readQueues[i][die_pointers[i]].front()->busPacketType)
+			    switch ((*next)->busPacketType)
 			    {
 			    case READ:
 			    case GC_READ:
 			    case ERASE:
-				log->log_ctrl_queue_event(false, readQueues[i][die_pointers[i]].front()->package, &readQueues[i][die_pointers[i]]);
+				log->log_ctrl_queue_event(false, (*next)->package, &readQueues[i][die_pointers[i]]);
 				break;
 			    case WRITE:
 			    case GC_WRITE:
 			    case DATA:
-				log->log_ctrl_queue_event(true, readQueues[i][die_pointers[i]].front()->package, &readQueues[i][die_pointers[i]]);
+				log->log_ctrl_queue_event(true, (*next)->package, &readQueues[i][die_pointers[i]]);
 				break;
 			    case FAST_WRITE:
 				break;
 			    }
 			}
-			readQueues[i][die_pointers[i]].pop_front();
-			parentNVDIMM->queuesNotFull();
+			readQueues[i][die_pointers[i]].erase(next);
+			if (MULTI_PLANE)
+			{
+			    mergePlanes(readQueues[i][die_pointers[i]], outgoingPackets[i]);
+			}
+			if(parentNVDIMM->ftl_waiting)
+			{
+			    parentNVDIMM->queuesNotFull();
+			}
 			if(BUFFERED)
 			{
 			  switch (outgoingPackets[i]->busPacketType){
@@ -586,7 +893,7 @@ void Controller::update(void){
 		    // couldn't get the channel so... Next die
 		    else
 		    {
-			done = nextDie(i);
+			done = nextDie(i, *next);
 		    }
 		}
 		// this queue is empty so move on
@@ -684,7 +991,8 @@ void Controller::update(void){
 
     //See if any read data is ready to return
     while (!returnTransaction.empty()){
-	if(FRONT_BUFFER)
+	// reads the nvdimm made for itself never go back to the host
+	if(FRONT_BUFFER && returnTransaction.back().origin == HOST_ORIGIN)
 	{
 	    // attempt to add the return transaction to the host channel buffer
 	    bool return_success = front_buffer->addTransaction(returnTransaction.back());
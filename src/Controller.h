@@ -83,9 +83,17 @@ namespace NVDSim{
 			void receiveFromChannel(ChannelPacket *busPacket);
 			bool checkQueueWrite(ChannelPacket *p);
 			bool addPacket(ChannelPacket *p);
+			bool firstDie(uint64_t package);
 			bool nextDie(uint64_t package);
+			bool nextDie(uint64_t package, ChannelPacket *tried);
+			void wakeDie(uint64_t package, uint64_t die);
+			std::list<ChannelPacket *>::iterator selectPacket(std::list<ChannelPacket *> &queue);
+			std::list<ChannelPacket *>::iterator multiPlaneData(std::list<ChannelPacket *> &queue, std::list<ChannelPacket *>::iterator lead);
+			std::list<ChannelPacket *>::iterator earliestDeadline(std::list<ChannelPacket *> &queue);
+			void mergePlanes(std::list<ChannelPacket *> &queue, ChannelPacket *lead);
 			void update(void);
 			bool dataReady(uint64_t package, uint64_t die, uint64_t plane);
+			bool writeNeeded(uint64_t package, uint64_t die);
 
 			void sendQueueLength(void);
 
@@ -102,6 +110,13 @@ namespace NVDSim{
 			bool* paused;
 			uint64_t* die_pointers; // for maintaining round robin fairness for channel access
 			uint64_t die_counter;
+			uint64_t die_start; // where die_pointers was when this package's search started
+
+			// one bit per die for each package, set when a die might be able to take something
+			// it gets set when a packet is queued for the die or the die changes state and cleared when the die was tried
+			// and either had nothing queued or couldn't take what it had, so the search only has to visit dies that could go
+			std::vector<std::vector<uint64_t> > ready_dies;
+			uint64_t firstReadyDie(uint64_t package, uint64_t start);
 			bool done;
 
 			uint64_t queue_access_counter;
@@ -114,6 +129,8 @@ namespace NVDSim{
 			std::vector<std::list <ChannelPacket *> > pendingPackets; //there can be a pending package for each plane of each die of each package
 			std::vector<uint64_t> channelXferCyclesLeft; //cycles per channel beat
 			std::vector<uint64_t> channelBeatsLeft; //channel beats per page
+			std::vector<std::vector<bool> > write_draining; //only used with ADAPTIVE_WRITE_DRAIN
+			std::vector<bool> plane_scratch; //planes that already have an older packet in the queue, used while scanning a die queue
 
 	};
 }
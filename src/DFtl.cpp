@@ -0,0 +1,319 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//DFtl.cpp
+//class file for the gc ftl with a demand paged mapping table
+//
+#include "DFtl.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+DFtl::DFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s) 
+    : GCFtl(c, l, p, s)
+{
+	map_start = VIRTUAL_TOTAL_SIZE * 1024;
+	entries_per_page = NV_PAGE_SIZE / MAP_ENTRY_SIZE;
+
+	lookups = vector<MapLookup>(slots.size(), MapLookup());
+}
+
+void DFtl::update(void){
+	GCFtl::update();
+	issueMapReads();
+}
+
+void DFtl::updateSlot(void){
+	uint64_t vAddr = currentTransaction.address;
+	bool unmapped_read = false;
+
+	// the same point the gc ftl would go ahead with the transaction, but it needs its map entry first
+	if (busy && lookupCounter <= 0 && !write_queues_full && needsLookup())
+	{
+	    if (!mapLookup())
+	    {
+		// still waiting on its translation page
+		return;
+	    }
+	    unmapped_read = DISK_READ && currentTransaction.transactionType == DATA_READ && !isMapped(vAddr);
+	}
+
+	GCFtl::updateSlot();
+
+	// a disk read maps the page it brings in, that changes the map just like a write
+	if (unmapped_read && isMapped(vAddr))
+	{
+	    markDirty(vAddr / NV_PAGE_SIZE);
+	}
+}
+
+// host reads and writes have to look up their page, the gc already knows where its pages are
+// and the writes of translation pages are placed through the directory
+bool DFtl::needsLookup(void)
+{
+	return (currentTransaction.transactionType == DATA_READ || currentTransaction.transactionType == DATA_WRITE) &&
+	    currentTransaction.address < map_start;
+}
+
+// true once the active slot's transaction has its map entry
+bool DFtl::mapLookup(void)
+{
+	uint64_t lpn = currentTransaction.address / NV_PAGE_SIZE;
+	MapLookup &lookup = lookups[active_slot];
+
+	if (lookup.address != currentTransaction.address || lookup.timeAdded != currentTransaction.timeAdded ||
+	    lookup.type != currentTransaction.transactionType)
+	{
+	    lookup.address = currentTransaction.address;
+	    lookup.timeAdded = currentTransaction.timeAdded;
+	    lookup.type = currentTransaction.transactionType;
+	    lookup.waiting = false;
+	    lookup.ready = false;
+	}
+	else if (lookup.ready || lookup.waiting)
+	{
+	    // already looked up, don't count it twice
+	    return lookup.ready;
+	}
+
+	unordered_map<uint64_t, MapEntry>::iterator it = map_cache.find(lpn);
+	if (it != map_cache.end())
+	{
+	    lru_list.splice(lru_list.begin(), lru_list, it->second.lru);
+	    if (LOGGING)
+	    {
+		log->map_cache_access(true);
+	    }
+	    lookup.ready = true;
+	    return true;
+	}
+
+	if (LOGGING)
+	{
+	    log->map_cache_access(false);
+	}
+	uint64_t tp = mapPage(lpn);
+	// nothing in this part of the map has ever been written or its translation page is still
+	// in the ftl queue, either way there is nothing in the flash to wait for
+	if (!isMapped(tp) || map_writes_queued.count(tp) != 0)
+	{
+	    insertEntry(lpn);
+	    lookup.ready = true;
+	    return true;
+	}
+
+	// several misses on one translation page share a read
+	if (fetching.find(tp) == fetching.end())
+	{
+	    fetching[tp] = currentClockCycle;
+	    map_reads.push_back(tp);
+	}
+	lookup.waiting = true;
+	return false;
+}
+
+// send the reads of translation pages to the controller ahead of anything in the ftl queues
+// the requests behind them are already waiting in their slots
+void DFtl::issueMapReads(void)
+{
+	while (!map_reads.empty())
+	{
+	    uint64_t tp = map_reads.front();
+	    ChannelPacket *commandPacket = Ftl::translate(READ, tp, addressMap[tp]);
+	    // translate copies these from whatever slot ran last, none of them belong to this read
+	    commandPacket->deadline = 0;
+	    commandPacket->tenant = 0;
+	    commandPacket->hostTimeAdded = fetching[tp];
+	    commandPacket->origin = MAP_ORIGIN;
+	    commandPacket->offset = 0;
+	    commandPacket->size = 0;
+
+	    if (!controller->addPacket(commandPacket))
+	    {
+		delete commandPacket;
+		return;
+	    }
+	    if (LOGGING)
+	    {
+		log->access_start(tp, DATA_READ);
+	    }
+	    map_reads.pop_front();
+	}
+}
+
+void DFtl::mapReadDone(uint64_t vAddr)
+{
+	unordered_map<uint64_t, uint64_t>::iterator it = fetching.find(vAddr);
+	if (it == fetching.end())
+	{
+	    ERROR("Got back a translation page that was never asked for: "<<vAddr);
+	    exit(1);
+	}
+	if (LOGGING)
+	{
+	    log->map_read(currentClockCycle - it->second);
+	}
+	fetching.erase(it);
+
+	// only the entries that missed are brought into the cache, not the rest of the page
+	for (uint64_t s = 0; s < lookups.size(); s++)
+	{
+	    if (lookups[s].waiting && mapPage(lookups[s].address / NV_PAGE_SIZE) == vAddr)
+	    {
+		insertEntry(lookups[s].address / NV_PAGE_SIZE);
+		lookups[s].waiting = false;
+		lookups[s].ready = true;
+	    }
+	}
+}
+
+// every shard keeps its own translation pages, they are dealt out in turn so NVDIMM::ftlFor can find the owner
+uint64_t DFtl::mapPage(uint64_t lpn)
+{
+	return map_start + ((lpn / entries_per_page) * FTL_SHARDS + shard) * NV_PAGE_SIZE;
+}
+
+// put an entry at the front of the cache, making room for it if it isn't there yet
+void DFtl::insertEntry(uint64_t lpn)
+{
+	unordered_map<uint64_t, MapEntry>::iterator it = map_cache.find(lpn);
+	if (it != map_cache.end())
+	{
+	    lru_list.splice(lru_list.begin(), lru_list, it->second.lru);
+	    return;
+	}
+
+	if (map_cache.size() >= MAP_CACHE_ENTRIES)
+	{
+	    uint64_t victim = lru_list.back();
+	    if (map_cache[victim].dirty)
+	    {
+		queueMapWrite(mapPage(victim));
+	    }
+	    map_cache.erase(victim);
+	    lru_list.pop_back();
+	}
+
+	lru_list.push_front(lpn);
+	MapEntry entry;
+	entry.lru = lru_list.begin();
+	entry.dirty = false;
+	map_cache[lpn] = entry;
+}
+
+void DFtl::markDirty(uint64_t lpn)
+{
+	insertEntry(lpn);
+	MapEntry &entry = map_cache[lpn];
+	if (!entry.dirty)
+	{
+	    entry.dirty = true;
+	    dirty_entries[mapPage(lpn)].push_back(lpn);
+	}
+}
+
+// write a translation page back
+// every changed entry of that page that is cached goes with it so they are all clean again
+void DFtl::queueMapWrite(uint64_t tp)
+{
+	unordered_map<uint64_t, vector<uint64_t> >::iterator dirty_it = dirty_entries.find(tp);
+	if (dirty_it != dirty_entries.end())
+	{
+	    for (uint64_t i = 0; i < dirty_it->second.size(); i++)
+	    {
+		unordered_map<uint64_t, MapEntry>::iterator it = map_cache.find(dirty_it->second[i]);
+		if (it != map_cache.end())
+		{
+		    it->second.dirty = false;
+		}
+	    }
+	    dirty_entries.erase(dirty_it);
+	}
+
+	// the write already waiting will pick up these changes too
+	if (map_writes_queued.count(tp) != 0)
+	{
+	    return;
+	}
+
+	// it goes in with the host's writes but is never turned away, the entry being evicted has to go somewhere
+	FlashTransaction trans = FlashTransaction(DATA_WRITE, tp, NULL);
+	trans.origin = MAP_ORIGIN;
+	trans.timeAdded = currentClockCycle;
+	if (SCHEDULE || PERFECT_SCHEDULE)
+	{
+	    attemptAdd(trans, &writeQueue, 0);
+	}
+	else
+	{
+	    attemptAdd(trans, &readQueue, 0);
+	    if (readQueue.size() == 1)
+	    {
+		read_pointer = readQueue.begin();
+	    }
+	}
+	map_writes_queued.insert(tp);
+}
+
+void DFtl::write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped)
+{
+	if (vAddr >= map_start)
+	{
+	    // a translation page, these don't count as host writes
+	    // its new location goes in the directory, which is just the address map
+	    GCFtl::write_success(block, page, vAddr, pAddr, true, mapped);
+	    if (!gc)
+	    {
+		map_writes_queued.erase(vAddr);
+		if (LOGGING)
+		{
+		    log->map_write();
+		}
+	    }
+	    return;
+	}
+
+	GCFtl::write_success(block, page, vAddr, pAddr, gc, mapped);
+
+	uint64_t lpn = vAddr / NV_PAGE_SIZE;
+	if (!gc || map_cache.find(lpn) != map_cache.end())
+	{
+	    markDirty(lpn);
+	}
+	else
+	{
+	    // the gc moved a page whose entry isn't cached, its translation page is updated in place
+	    queueMapWrite(mapPage(lpn));
+	}
+}
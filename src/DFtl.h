@@ -0,0 +1,117 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVDFTL_H
+#define NVDFTL_H
+//DFtl.h
+//header file for the gc ftl that keeps its page map in the flash, see DFTL
+//
+//The whole page map no longer has to fit in the controller. It is split into
+//translation pages of NV_PAGE_SIZE / MAP_ENTRY_SIZE entries that live in the
+//flash like any other page and only MAP_CACHE_ENTRIES entries are cached in
+//the controller, least recently used goes first. A host request whose entry
+//isn't cached waits while its translation page is read in. Evicting an entry
+//that changed since it was read in writes its translation page back, taking
+//every other changed entry of that page with it. Where each translation page
+//is sits in the regular address map, which stands in for the small directory
+//that stays in the controller, so the gc moves translation pages for free.
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "GCFtl.h"
+
+namespace NVDSim{
+        class NVDIMM;
+	class DFtl : public GCFtl{
+		public:
+	                DFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s);
+			void update(void);
+			void updateSlot(void);
+			void write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped);
+
+			void mapReadDone(uint64_t vAddr);
+
+		private:
+			// one cached entry of the page map
+			class MapEntry
+			{
+			public:
+			    std::list<uint64_t>::iterator lru; // where it is in the lru list
+			    bool dirty; // changed since its translation page was last written
+			};
+
+			// what the map lookup for a slot's transaction has gotten to
+			// a transaction the slot gave up on and picked up again keeps its lookup
+			class MapLookup
+			{
+			public:
+			    uint64_t address;
+			    uint64_t timeAdded;
+			    TransactionType type;
+			    bool waiting; // for its translation page to come in
+			    bool ready; // its entry was there, it is free to go
+
+			    MapLookup()
+			    {
+				address = 0;
+				timeAdded = 0;
+				type = EMPTY;
+				waiting = false;
+				ready = false;
+			    }
+			};
+
+			bool needsLookup(void);
+			bool mapLookup(void);
+			void issueMapReads(void);
+			uint64_t mapPage(uint64_t lpn);
+			void insertEntry(uint64_t lpn);
+			void markDirty(uint64_t lpn);
+			void queueMapWrite(uint64_t tp);
+
+			uint64_t map_start; // vAddr of the first translation page, right past the host's space
+			uint64_t entries_per_page;
+
+			std::list<uint64_t> lru_list; // cached logical pages, most recently used at the front
+			std::unordered_map<uint64_t, MapEntry> map_cache; // logical page to its cached entry
+			std::unordered_map<uint64_t, std::vector<uint64_t> > dirty_entries; // translation page to its cached entries that changed
+
+			std::vector<MapLookup> lookups; // one per slot
+			std::list<uint64_t> map_reads; // translation pages waiting for room in the controller
+			std::unordered_map<uint64_t, uint64_t> fetching; // translation pages being read in to the cycle the miss went out
+			std::unordered_set<uint64_t> map_writes_queued; // translation pages with a write in the ftl queue
+	};
+}
+#endif
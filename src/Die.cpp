@@ -52,6 +52,10 @@ Die::Die(NVDIMM *parent, Logger *l, uint64_t idNum){
 	planes= vector<Plane>(PLANES_PER_DIE, Plane());
 
 	currentCommands= vector<ChannelPacket *>(PLANES_PER_DIE, NULL);
+	cachedCommands= vector<ChannelPacket *>(PLANES_PER_DIE, NULL);
+	suspendedCommands= vector<ChannelPacket *>(PLANES_PER_DIE, NULL);
+	suspendedCyclesLeft= vector<uint64_t>(PLANES_PER_DIE, 0);
+	suspendCount= vector<uint64_t>(PLANES_PER_DIE, 0);
 
 	dataCyclesLeft= 0;
 	deviceBeatsLeft= 0;
@@ -67,76 +71,102 @@ void Die::attachToBuffer(Buffer *buff){
 }
 
 void Die::receiveFromBuffer(ChannelPacket *busPacket){
+	// multi-plane command, every plane in it starts now so they all share the same array time
+	if (busPacket->nextPlane != NULL){
+		ChannelPacket *rest = busPacket->nextPlane;
+		busPacket->nextPlane = NULL;
+		receiveFromBuffer(busPacket);
+		receiveFromBuffer(rest);
+		return;
+	}
+
 	if (busPacket->busPacketType == DATA){
 		planes[busPacket->plane].storeInData(busPacket);
 	} else if (currentCommands[busPacket->plane] == NULL) {
-		currentCommands[busPacket->plane] = busPacket;
-		if (LOGGING)
-		{
-			// Tell the logger the access has now been processed.		        
-			log->access_process(busPacket->virtualAddress, busPacket->physicalAddress, busPacket->package, busPacket->busPacketType);		
-		}
-		switch (busPacket->busPacketType){
-			case READ:
-		        case GC_READ:
-			        planes[busPacket->plane].read(busPacket);
-				controlCyclesLeft[busPacket->plane]= READ_CYCLES;
-				// log the new state of this plane
-				if(LOGGING && PLANE_STATE_LOG)
-				{
-				    if(busPacket->busPacketType == READ)
-				    {
-					log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, READING);
-				    }
-				    else if(busPacket->busPacketType == GC_READ)
-				    {
-					log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, GC_READING);
-				    }
-				}
-				break;
-			case WRITE:
-			case GC_WRITE:
-			    	planes[busPacket->plane].write(busPacket);
-				parentNVDIMM->numWrites++;			
-			        if((DEVICE_TYPE.compare("PCM") == 0 || DEVICE_TYPE.compare("P8P") == 0) && GARBAGE_COLLECT == 0)
-				{
-					controlCyclesLeft[busPacket->plane]= ERASE_CYCLES;
-				}
-				else
-				{
-					controlCyclesLeft[busPacket->plane]= WRITE_CYCLES;
-				}
-				// log the new state of this plane
-				if(LOGGING && PLANE_STATE_LOG)
-				{
-				    if(busPacket->busPacketType == WRITE)
-				    {
-					log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, WRITING);
-				    }
-				    else if(busPacket->busPacketType == GC_WRITE)
-				    {
-					log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, GC_WRITING);
-				    }
-				}
-				break;
-			case ERASE:
-			        planes[busPacket->plane].erase(busPacket);
-			        parentNVDIMM->numErases++;
-			        controlCyclesLeft[busPacket->plane]= ERASE_CYCLES;
-
-				// log the new state of this plane
-				if(LOGGING && PLANE_STATE_LOG)
-				{
-				    log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, ERASING);
-				}
-				break;
-			default:
-				break;			
-		}
+		startCommand(busPacket);
+	} else if (suspendReady(busPacket->plane, busPacket->busPacketType)) {
+		// read cuts in front of an erase or program, which picks up where it left off once the read is done
+		suspendCommand(busPacket->plane);
+		startCommand(busPacket);
+		controlCyclesLeft[busPacket->plane] += SUSPEND_CYCLES;
+	} else if (CACHE_MODE && cachedCommands[busPacket->plane] == NULL) {
+		// cache read or cache program, this one starts as soon as the plane finishes its current command
+		cachedCommands[busPacket->plane] = busPacket;
 	} else{
 		ERROR("Die is busy");
 		exit(1);
 	}
+	wakeController();
+}
+
+void Die::startCommand(ChannelPacket *busPacket){
+	currentCommands[busPacket->plane] = busPacket;
+	if (busPacket->busPacketType == WRITE || busPacket->busPacketType == GC_WRITE || busPacket->busPacketType == ERASE)
+	{
+		suspendCount[busPacket->plane] = 0;
+	}
+	if (LOGGING)
+	{
+		// Tell the logger the access has now been processed.		        
+		log->access_process(busPacket->virtualAddress, busPacket->physicalAddress, busPacket->package, busPacket->busPacketType);		
+	}
+	switch (busPacket->busPacketType){
+		case READ:
+	        case GC_READ:
+		        planes[busPacket->plane].read(busPacket);
+			controlCyclesLeft[busPacket->plane]= READ_CYCLES;
+			// log the new state of this plane
+			if(LOGGING && PLANE_STATE_LOG)
+			{
+			    if(busPacket->busPacketType == READ)
+			    {
+				log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, READING);
+			    }
+			    else if(busPacket->busPacketType == GC_READ)
+			    {
+				log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, GC_READING);
+			    }
+			}
+			break;
+		case WRITE:
+		case GC_WRITE:
+		    	planes[busPacket->plane].write(busPacket);
+			parentNVDIMM->numWrites++;			
+		        if((DEVICE_TYPE.compare("PCM") == 0 || DEVICE_TYPE.compare("P8P") == 0) && GARBAGE_COLLECT == 0)
+			{
+				controlCyclesLeft[busPacket->plane]= ERASE_CYCLES;
+			}
+			else
+			{
+				controlCyclesLeft[busPacket->plane]= WRITE_CYCLES;
+			}
+			// log the new state of this plane
+			if(LOGGING && PLANE_STATE_LOG)
+			{
+			    if(busPacket->busPacketType == WRITE)
+			    {
+				log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, WRITING);
+			    }
+			    else if(busPacket->busPacketType == GC_WRITE)
+			    {
+				log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, GC_WRITING);
+			    }
+			}
+			break;
+		case ERASE:
+		        planes[busPacket->plane].erase(busPacket);
+		        parentNVDIMM->eraseDone(busPacket->physicalAddress);
+		        controlCyclesLeft[busPacket->plane]= ERASE_CYCLES;
+
+			// log the new state of this plane
+			if(LOGGING && PLANE_STATE_LOG)
+			{
+			    log->log_plane_state(busPacket->virtualAddress, busPacket->package, busPacket->die, busPacket->plane, ERASING);
+			}
+			break;
+		default:
+			break;			
+	}
 }
 
 int Die::isDieBusy(uint64_t plane){
@@ -165,6 +195,114 @@ int Die::isDieBusy(uint64_t plane){
     return 1;
 }
 
+// can the target plane take this packet right now
+bool Die::planeReady(ChannelPacket *p){
+    return planeReady(p->plane, p->busPacketType);
+}
+
+bool Die::planeReady(uint64_t plane, ChannelPacketType type){
+    // the plane is busy but the command can wait in the cache slot or suspend what the plane is doing
+    if ((CACHE_MODE && cacheReady(plane, type)) || suspendReady(plane, type))
+    {
+	return true;
+    }
+
+    int busy = isDieBusy(plane);
+    // plane is working on something
+    if (busy == 1)
+    {
+	return false;
+    }
+    // plane is writing but has room in the cache reg, only data can go in
+    else if (busy == 2 && type != DATA)
+    {
+	return false;
+    }
+    // cache reg is already loaded so no more data for now
+    else if (busy == 3 && type == DATA)
+    {
+	return false;
+    }
+    return true;
+}
+
+// cache read: the next read can be issued while the array is still sensing the current one
+// cache program: the next write can be issued once its data is in the cache reg while the array programs from the data reg
+bool Die::cacheReady(uint64_t plane, ChannelPacketType type){
+    if (currentCommands[plane] == NULL || cachedCommands[plane] != NULL || suspendedCommands[plane] != NULL ||
+	currentCommands[plane]->busPacketType != type)
+    {
+	return false;
+    }
+    if (type == READ || type == GC_READ)
+    {
+	return true;
+    }
+    else if (type == WRITE || type == GC_WRITE)
+    {
+	return !planes[plane].checkCacheReg();
+    }
+    return false;
+}
+
+// can a read suspend the erase or program the plane is working on
+bool Die::suspendReady(uint64_t plane, ChannelPacketType type){
+    ChannelPacket *current = currentCommands[plane];
+    if (type != READ || current == NULL || suspendedCommands[plane] != NULL || suspendCount[plane] >= MAX_SUSPENDS ||
+	controlCyclesLeft[plane] == 0)
+    {
+	return false;
+    }
+
+    if (current->busPacketType == ERASE)
+    {
+	return ERASE_SUSPEND;
+    }
+    // the read data comes out through the cache reg so it has to be empty
+    else if (current->busPacketType == WRITE || current->busPacketType == GC_WRITE)
+    {
+	return PROGRAM_SUSPEND && planes[plane].checkCacheReg();
+    }
+    return false;
+}
+
+void Die::suspendCommand(uint64_t plane){
+    suspendedCommands[plane] = currentCommands[plane];
+    suspendedCyclesLeft[plane] = controlCyclesLeft[plane];
+    suspendCount[plane]++;
+    currentCommands[plane] = NULL;
+    planes[plane].suspend();
+
+    if (LOGGING)
+    {
+	log->suspended();
+    }
+}
+
+void Die::resumeCommand(uint64_t plane){
+    ChannelPacket *resumed = suspendedCommands[plane];
+    currentCommands[plane] = resumed;
+    controlCyclesLeft[plane] = suspendedCyclesLeft[plane] + RESUME_CYCLES;
+    suspendedCommands[plane] = NULL;
+    planes[plane].resume();
+
+    if (LOGGING && PLANE_STATE_LOG)
+    {
+	if (resumed->busPacketType == ERASE)
+	{
+	    log->log_plane_state(resumed->virtualAddress, resumed->package, resumed->die, resumed->plane, ERASING);
+	}
+	else if (resumed->busPacketType == GC_WRITE)
+	{
+	    log->log_plane_state(resumed->virtualAddress, resumed->package, resumed->die, resumed->plane, GC_WRITING);
+	}
+	else
+	{
+	    log->log_plane_state(resumed->virtualAddress, resumed->package, resumed->die, resumed->plane, WRITING);
+	}
+    }
+}
+
 void Die::update(void){
 	uint64_t i;
 	ChannelPacket *currentCommand;
@@ -189,20 +327,25 @@ void Die::update(void){
 					    }
 					    break;
 					case GC_READ:
-					    if(returnDataPackets.size() <= PLANES_PER_DIE)
+					    if(returnDataPackets.size() <= PLANES_PER_DIE && planes[currentCommand->plane].checkCacheReg())
 					    {
 						returnDataPackets.push(planes[currentCommand->plane].readFromData());
 						parentNVDIMM->GCReadDone(currentCommand->virtualAddress);
 					    }
+					    else
+					    {
+						// same as a read, dropping it here would leave its data stuck in the register
+						no_reg_room = true;
+					    }
 					    break;
 					case WRITE:	
 						//call write callback					   
-					    if (parentNVDIMM->WriteDataDone != NULL){
-						(*parentNVDIMM->WriteDataDone)(parentNVDIMM->systemID, currentCommand->virtualAddress, currentClockCycle,true);
-					    }
+					    parentNVDIMM->writeDone(currentCommand, currentClockCycle);
 					    planes[currentCommand->plane].writeDone(currentCommand);
 					    break;
 				        case GC_WRITE:
+					    // no callback for the gc but the data still has to come out of the register
+					    planes[currentCommand->plane].writeDone(currentCommand);
 					    break;
 					case ERASE:
 					    break;
@@ -237,7 +380,21 @@ void Die::update(void){
 				{
 				    //sim output
 				    currentCommands[i]= NULL;
+
+				    // a suspended erase or program takes priority over anything else
+				    if(suspendedCommands[i] != NULL)
+				    {
+					resumeCommand(i);
+				    }
+				    // the cached command goes right away without waiting on the channel
+				    else if(cachedCommands[i] != NULL)
+				    {
+					ChannelPacket *next = cachedCommands[i];
+					cachedCommands[i] = NULL;
+					startCommand(next);
+				    }
 				}
+				wakeController();
 			}
 			// sanity check
 			if(controlCyclesLeft[i] > 0)
@@ -257,13 +414,13 @@ void Die::update(void){
 		    currentCommands[returnDataPackets.front()->plane] != NULL))
 		{
 		    dataCyclesLeft = divide_params_64b(DEVICE_CYCLE,CYCLE_TIME);
-		    deviceBeatsLeft = divide_params_64b((NV_PAGE_SIZE*8),DEVICE_WIDTH);
+		    deviceBeatsLeft = divide_params_64b((returnDataPackets.front()->transferSize()*8),DEVICE_WIDTH);
 		    sending = true;
 		}
 		    
 		if(dataCyclesLeft == 0 && deviceBeatsLeft > 0){
 		    bool success = false;
-		    success = buffer->sendPiece(BUFFER, 0, id, returnDataPackets.front()->plane);
+		    success = buffer->sendPiece(BUFFER, 0, id, returnDataPackets.front()->plane, returnDataPackets.front()->transferSize()*8);
 		    if(success == true)
 		    {
 			deviceBeatsLeft--;
@@ -296,6 +453,7 @@ void Die::update(void){
 			buffer->channel->sendToController(returnDataPackets.front());
 			buffer->channel->releaseChannel(BUFFER, id);		
 			returnDataPackets.pop();
+			wakeController();
 		    }
 		    if(CRIT_LINE_FIRST && dataCyclesLeft == critBeat)
 		    {
@@ -310,7 +468,7 @@ void Die::update(void){
 		    {
 			if(buffer->channel->obtainChannel(id, BUFFER, NULL))
 			{
-			    dataCyclesLeft = (divide_params_64b((NV_PAGE_SIZE*8),DEVICE_WIDTH) * DEVICE_CYCLE) / CYCLE_TIME;
+			    dataCyclesLeft = (divide_params_64b((returnDataPackets.front()->transferSize()*8),DEVICE_WIDTH) * DEVICE_CYCLE) / CYCLE_TIME;
 			}
 		    }
 		}
@@ -342,6 +500,13 @@ void Die::bufferLoaded()
     planes[returnDataPackets.front()->plane].dataGone();
     returnDataPackets.pop();	
     sending = false;
+    wakeController();
+}
+
+// let the controller know this die may be able to take something it couldn't before
+void Die::wakeController(void)
+{
+    buffer->channel->controller->wakeDie(buffer->id, id);
 }
 
 void Die::critLineDone()
@@ -55,6 +55,8 @@ namespace NVDSim{
 			void attachToBuffer(Buffer *buff);
 			void receiveFromBuffer(ChannelPacket *busPacket);
 			int isDieBusy(uint64_t plane);
+			bool planeReady(ChannelPacket *p);
+			bool planeReady(uint64_t plane, ChannelPacketType type);
 			void update(void);
 			void channelDone(void);
 			void bufferDone(uint64_t plane);
@@ -65,6 +67,13 @@ namespace NVDSim{
 			void writeToPlane(ChannelPacket *packet);
 
 		private:
+			void startCommand(ChannelPacket *busPacket);
+			bool cacheReady(uint64_t plane, ChannelPacketType type);
+			bool suspendReady(uint64_t plane, ChannelPacketType type);
+			void suspendCommand(uint64_t plane);
+			void resumeCommand(uint64_t plane);
+			void wakeController(void);
+
 			uint64_t id;
 			NVDIMM *parentNVDIMM;
 			Buffer *buffer;
@@ -77,6 +86,10 @@ namespace NVDSim{
 			std::queue<ChannelPacket *> pendingDataPackets;
 			std::vector<Plane> planes;
 			std::vector<ChannelPacket *> currentCommands;
+			std::vector<ChannelPacket *> cachedCommands; // next command for each plane in cache mode
+			std::vector<ChannelPacket *> suspendedCommands; // erase or program paused for a read
+			std::vector<uint64_t> suspendedCyclesLeft;
+			std::vector<uint64_t> suspendCount; // suspends so far for the erase or program on each plane
 			uint64_t *controlCyclesLeft;
 	};
 }
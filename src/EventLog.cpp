@@ -0,0 +1,186 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//EventLog.cpp
+//Binary trace of the queue and plane state events
+
+#include "EventLog.h"
+#include "FlashConfiguration.h"
+
+using namespace NVDSim;
+using namespace std;
+
+// buffers we're willing to have in flight before the simulation has to wait on the writer
+#define MAX_EVENT_BUFFERS 4
+
+EventLog::EventLog(string filename, uint64_t buffer_bytes)
+{
+	records_per_buffer = buffer_bytes / sizeof(EventRecord);
+	if (records_per_buffer == 0)
+	{
+	    records_per_buffer = 1;
+	}
+
+	file.open(filename.c_str(), ios_base::out | ios_base::trunc | ios_base::binary);
+	if (!file)
+	{
+	    ERROR("Cannot open "<<filename);
+	    exit(-1);
+	}
+
+	// header so the decoder can sanity check what it is reading
+	const char magic[8] = {'N','V','D','E','V','T','0','1'};
+	uint64_t record_size = sizeof(EventRecord);
+	file.write(magic, sizeof(magic));
+	file.write((const char *)&record_size, sizeof(record_size));
+
+	current = new vector<EventRecord>();
+	current->reserve(records_per_buffer);
+	num_buffers = 1;
+
+	writing = false;
+	done = false;
+
+	writer = thread(&EventLog::writer_loop, this);
+}
+
+EventLog::~EventLog()
+{
+	flush();
+
+	{
+	    unique_lock<mutex> l(lock);
+	    done = true;
+	}
+	buffer_full.notify_one();
+	writer.join();
+
+	file.close();
+
+	delete current;
+	while (!free_buffers.empty())
+	{
+	    delete free_buffers.front();
+	    free_buffers.pop_front();
+	}
+}
+
+void EventLog::record(EventRecordType type, uint64_t cycle, uint64_t address, uint64_t package, uint64_t die, uint64_t plane, 
+		      uint64_t value, uint64_t op)
+{
+	EventRecord r;
+	r.cycle = cycle;
+	r.address = address;
+	r.value = (uint32_t)value;
+	r.package = (uint16_t)package;
+	r.die = (uint16_t)die;
+	r.plane = (uint16_t)plane;
+	r.type = (uint8_t)type;
+	r.op = (uint8_t)op;
+	r.reserved = 0;
+	current->push_back(r);
+
+	if (current->size() >= records_per_buffer)
+	{
+	    retire_buffer();
+	}
+}
+
+// hand the current buffer to the writer and get an empty one to keep filling
+void EventLog::retire_buffer(void)
+{
+	unique_lock<mutex> l(lock);
+	full_buffers.push_back(current);
+	buffer_full.notify_one();
+
+	if (free_buffers.empty() && num_buffers < MAX_EVENT_BUFFERS)
+	{
+	    current = new vector<EventRecord>();
+	    current->reserve(records_per_buffer);
+	    num_buffers++;
+	    return;
+	}
+
+	// writer has fallen behind, wait for it to give something back
+	while (free_buffers.empty())
+	{
+	    buffer_free.wait(l);
+	}
+	current = free_buffers.front();
+	free_buffers.pop_front();
+}
+
+void EventLog::flush(void)
+{
+	if (!current->empty())
+	{
+	    retire_buffer();
+	}
+
+	unique_lock<mutex> l(lock);
+	while (!full_buffers.empty() || writing)
+	{
+	    buffer_free.wait(l);
+	}
+	file.flush();
+}
+
+void EventLog::writer_loop(void)
+{
+	unique_lock<mutex> l(lock);
+	while (true)
+	{
+	    while (full_buffers.empty() && !done)
+	    {
+		buffer_full.wait(l);
+	    }
+	    if (full_buffers.empty() && done)
+	    {
+		return;
+	    }
+
+	    vector<EventRecord> *buffer = full_buffers.front();
+	    full_buffers.pop_front();
+	    writing = true;
+
+	    // don't hold the lock while we're waiting on the disk
+	    l.unlock();
+	    file.write((const char *)&(*buffer)[0], buffer->size() * sizeof(EventRecord));
+	    buffer->clear();
+	    l.lock();
+
+	    writing = false;
+	    free_buffers.push_back(buffer);
+	    buffer_free.notify_all();
+	}
+}
@@ -0,0 +1,117 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVEVENTLOG_H
+#define NVEVENTLOG_H
+
+//EventLog.h
+//Binary trace of the queue and plane state events
+//
+//The text event logs reopen their file for every single event which makes them
+//far too slow to leave on for a long run. Here every event is packed into a
+//fixed size record and appended to a large in memory buffer. Full buffers are
+//handed off to a writer thread so the simulation never waits on the disk unless
+//the writer falls a whole set of buffers behind.
+//The file can be turned back into a csv with tools/event_log/decode_events.py
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+namespace NVDSim
+{
+    enum EventRecordType
+    {
+	FTL_READ_QUEUE_EVENT,
+	FTL_WRITE_QUEUE_EVENT,
+	CTRL_READ_QUEUE_EVENT,
+	CTRL_WRITE_QUEUE_EVENT,
+	PLANE_STATE_EVENT
+    };
+
+    // on disk layout of each event, this has to match the format string in the decoder
+    struct EventRecord
+    {
+	uint64_t cycle;
+	uint64_t address; // address at the head of the queue or the address the plane is working on
+	uint32_t value; // queue length or plane state
+	uint16_t package;
+	uint16_t die;
+	uint16_t plane;
+	uint8_t type;
+	uint8_t op; // transaction type of the head of the queue
+	uint32_t reserved;
+    };
+
+    class EventLog
+    {
+    public:
+	EventLog(std::string filename, uint64_t buffer_bytes);
+	~EventLog();
+
+	void record(EventRecordType type, uint64_t cycle, uint64_t address, uint64_t package, uint64_t die, uint64_t plane, 
+		    uint64_t value, uint64_t op);
+	// push everything recorded so far out to the file
+	void flush(void);
+
+    private:
+	void retire_buffer(void);
+	void writer_loop(void);
+
+	std::ofstream file;
+
+	uint64_t records_per_buffer;
+	uint64_t num_buffers;
+
+	// only touched by the simulation thread
+	std::vector<EventRecord> *current;
+
+	// shared with the writer thread, protected by lock
+	std::list<std::vector<EventRecord> *> full_buffers;
+	std::list<std::vector<EventRecord> *> free_buffers;
+	bool writing;
+	bool done;
+
+	std::mutex lock;
+	std::condition_variable buffer_full;
+	std::condition_variable buffer_free;
+	std::thread writer;
+    };
+}
+
+#endif
@@ -113,6 +113,21 @@ extern bool CTRL_SCHEDULE;
 extern bool CTRL_WRITE_ON_QUEUE_SIZE;
 extern uint64_t CTRL_WRITE_QUEUE_LIMIT;
 extern bool CTRL_IDLE_WRITE;
+extern bool CTRL_OUT_OF_ORDER;
+extern uint64_t CTRL_OOO_WINDOW; // how many packets into each die queue the scheduler looks
+extern uint64_t CTRL_OOO_AGE_CAP; // in controller cycles, 0 means no cap
+extern bool DEADLINE_SCHEDULE; // earliest deadline first in the ftl and the controller
+extern std::string TENANT_WEIGHTS; // comma separated deficit round robin weight for each tenant, a single tenant turns it off
+extern uint64_t TENANT_QUEUE_LENGTH; // transactions each tenant can have waiting to get into the nvdimm
+extern bool ADAPTIVE_WRITE_DRAIN; // replaces WRITE_QUEUE_LIMIT and CTRL_WRITE_QUEUE_LIMIT with the watermarks below
+extern float DRAIN_HIGH_WATERMARK; // fraction of a write queue, the most the adaptive high watermark can go up to
+extern float DRAIN_LOW_WATERMARK; // fraction of a write queue, a drain stops once the queue is down to this
+extern uint64_t DRAIN_WINDOW; // cycles between adjustments of the high watermark
+extern bool MULTI_PLANE;
+extern bool CACHE_MODE;
+extern bool ERASE_SUSPEND;
+extern bool PROGRAM_SUSPEND;
+extern uint64_t MAX_SUSPENDS; // times one erase or program can be suspended
 extern bool PERFECT_SCHEDULE;
 extern bool ENABLE_WRITE_SCRIPT;
 extern std::string NV_WRITE_SCRIPT;
@@ -130,20 +145,62 @@ extern bool BUFFERED;
 extern bool CUT_THROUGH;
 extern uint64_t IN_BUFFER_SIZE;
 extern uint64_t OUT_BUFFER_SIZE;
+extern bool READ_CACHE; // dram cache for reads in front of the ftl
+extern uint64_t READ_CACHE_SIZE; // in bytes
+extern uint64_t READ_CACHE_LINE_SIZE; // in bytes, has to divide the page size
+extern uint64_t READ_CACHE_WAYS; // 0 for fully associative
+extern std::string READ_CACHE_POLICY; // LRU, ARC or CLOCK
+extern uint64_t READ_CACHE_HIT_LATENCY; // in cycles
+extern bool WRITE_BUFFER; // write back dram buffer that combines host writes into pages
+extern uint64_t WRITE_BUFFER_PAGES;
+extern uint64_t WRITE_BUFFER_LINE_SIZE; // in bytes, how much each host write covers, has to divide the page size
+extern uint64_t WRITE_BUFFER_MAX_AGE; // in cycles, a page is flushed once it has been buffered this long
+extern uint64_t WRITE_BUFFER_LATENCY; // in cycles, for writes into the buffer and reads out of it
+extern bool PREFETCH; // read ahead of sequential streams into the read cache, needs READ_CACHE
+extern uint64_t PREFETCH_STREAMS; // how many streams are tracked at once
+extern uint64_t PREFETCH_TRIGGER; // sequential pages a stream has to read before we start fetching ahead of it
+extern uint64_t PREFETCH_DEPTH; // in pages, how far ahead of a stream we fetch
+extern float PREFETCH_QUEUE_OCCUPANCY; // prefetches are only issued while the ftl read queue is less full than this
 
 // Critical Cache Line First Options 
 extern bool CRIT_LINE_FIRST;
 
+// Partial Read Options
+extern bool PARTIAL_READS; // reads with a size only move the sectors they need off of the die
+extern uint64_t SECTOR_SIZE; // in bytes, has to divide the page size
+
+// Sector Mapping Options
+extern bool SECTOR_MAPPING; // the gc ftl maps host sectors into pages instead of whole pages
+extern uint64_t HOST_SECTOR_SIZE; // in bytes, what each host address covers, has to divide the page size
+extern uint64_t SECTOR_PACK_TIME; // in cycles, how long a partly packed page waits for more sectors
+
+// Mapping Cache Options
+extern bool DFTL; // the gc ftl keeps its page map in flash and only caches part of it in the controller
+extern uint64_t MAP_CACHE_ENTRIES; // how many page map entries the controller can hold
+extern uint64_t MAP_ENTRY_SIZE; // in bytes, one entry of the page map, has to divide the page size
+
+// Log Block Mapping Options
+extern bool LOG_BLOCK_FTL; // the gc ftl maps data by block and only keeps a few page mapped log blocks for updates
+extern std::string LOG_BLOCK_SCHEME; // BAST gives each log block to one data block, FAST shares them all
+extern uint64_t LOG_BLOCKS; // how many log blocks there can be at once
+
 // Logging Options
 extern bool LOGGING;
 extern std::string LOG_DIR;
 extern bool WEAR_LEVEL_LOG;
+extern bool WEAR_LEVEL_EXACT;
+extern uint64_t WEAR_SKETCH_WIDTH;
+extern uint64_t WEAR_SKETCH_DEPTH;
+extern uint64_t WEAR_TOP_K;
 extern bool RUNTIME_WRITE;
 extern bool PER_PACKAGE;
 extern bool QUEUE_EVENT_LOG;
 extern bool PLANE_STATE_LOG;
 extern bool WRITE_ARRIVE_LOG;
 extern bool READ_ARRIVE_LOG;
+extern bool BINARY_EVENT_LOG;
+extern uint64_t EVENT_LOG_BUFFER_SIZE; // in bytes
+extern std::string STATS_FORMAT; // json, csv or none
 
 // Save and Restore Options
 extern bool ENABLE_NV_SAVE;
@@ -198,6 +255,10 @@ extern uint64_t WRITE_TIME;
 #define WRITE_CYCLES (divide_params_64b(WRITE_TIME, CYCLE_TIME))
 extern uint64_t ERASE_TIME;
 #define ERASE_CYCLES (divide_params_64b(ERASE_TIME, CYCLE_TIME))
+extern uint64_t SUSPEND_TIME;
+#define SUSPEND_CYCLES (divide_params_64b(SUSPEND_TIME, CYCLE_TIME))
+extern uint64_t RESUME_TIME;
+#define RESUME_CYCLES (divide_params_64b(RESUME_TIME, CYCLE_TIME))
 extern uint64_t COMMAND_LENGTH; //in bits, including address
 extern uint64_t LOOKUP_TIME;
 #define LOOKUP_CYCLES (divide_params_64b(LOOKUP_TIME, CYCLE_TIME))
@@ -215,6 +276,8 @@ extern uint64_t FTL_READ_QUEUE_LENGTH;
 extern uint64_t FTL_WRITE_QUEUE_LENGTH;
 extern uint64_t CTRL_READ_QUEUE_LENGTH;
 extern uint64_t CTRL_WRITE_QUEUE_LENGTH;
+extern uint64_t FTL_SLOTS; // transactions the ftl can be working on at once
+extern uint64_t FTL_SHARDS; // independent ftls, each owning a slice of the address space and of the blocks
 
 // Power stuff
 extern double READ_I;
@@ -45,6 +45,13 @@ using namespace std;
 FlashTransaction::FlashTransaction()
 {
     transactionType = EMPTY;
+    timeAdded = 0;
+    deadline = 0;
+    tenant = 0;
+    origin = HOST_ORIGIN;
+    offset = 0;
+    size = 0;
+    cache_generation = 0;
 }
 
 FlashTransaction::FlashTransaction(TransactionType transType, uint64_t addr, void *dat)
@@ -52,6 +59,46 @@ FlashTransaction::FlashTransaction(TransactionType transType, uint64_t addr, voi
 	transactionType = transType;
 	address = addr;
 	data = dat;
+	timeAdded = 0;
+	deadline = 0;
+	tenant = 0;
+	origin = HOST_ORIGIN;
+	offset = 0;
+	size = 0;
+	cache_generation = 0;
+}
+
+FlashTransaction::FlashTransaction(TransactionType transType, uint64_t addr, void *dat, uint64_t dl)
+{
+	transactionType = transType;
+	address = addr;
+	data = dat;
+	timeAdded = 0;
+	deadline = dl;
+	tenant = 0;
+	origin = HOST_ORIGIN;
+	offset = 0;
+	size = 0;
+	cache_generation = 0;
+}
+
+FlashTransaction::FlashTransaction(TransactionType transType, const ChannelPacket *packet)
+{
+	transactionType = transType;
+	address = packet->virtualAddress;
+	data = packet->data;
+	timeAdded = packet->hostTimeAdded;
+	deadline = packet->deadline;
+	tenant = packet->tenant;
+	origin = packet->origin;
+	offset = packet->offset;
+	size = packet->size;
+	cache_generation = packet->cache_generation;
+}
+
+uint64_t FlashTransaction::transferSize(void) const
+{
+	return ChannelPacket::transferSize(offset, size);
 }
 
 void FlashTransaction::print()
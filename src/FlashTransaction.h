@@ -39,6 +39,7 @@
 //Header file for transaction object
 
 #include "FlashConfiguration.h"
+#include "ChannelPacket.h"
 
 using namespace std;
 
@@ -65,13 +66,27 @@ namespace NVDSim
 		void *data;
 		uint64_t timeAdded;
 		uint64_t timeReturned;
+		uint64_t deadline; // cycle the host wants this done by, 0 for no deadline
+		uint64_t tenant; // which host stream this belongs to, see TENANT_WEIGHTS
+		TransactionOrigin origin;
+		// with PARTIAL_READS a read can ask for size bytes starting offset bytes into the page at address
+		// a size of 0 means the whole page, the nvdimm moves any offset in the address over into offset when the read is added
+		uint64_t offset;
+		uint64_t size;
+		// the read cache generation when a read was sent, see ReadCache::generation
+		uint64_t cache_generation;
 
 		
 		//functions
 		FlashTransaction(TransactionType transType, uint64_t addr, void *data);
+		FlashTransaction(TransactionType transType, uint64_t addr, void *data, uint64_t deadline);
+		// takes the address, data and request info from a packet that is being returned to the host
+		FlashTransaction(TransactionType transType, const ChannelPacket *packet);
 		FlashTransaction();
 		
 		void print();
+		// bytes that have to come off of the die for this read
+		uint64_t transferSize(void) const;
 	};
 }
 
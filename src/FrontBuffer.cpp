@@ -53,6 +53,7 @@ FrontBuffer::FrontBuffer(NVDIMM* parent, Ftl* f){
     // usage of buffer space
     requestsSize = 0;
     responsesSize = 0;
+    host_waiting = false;
     
     // transaction currently being serviced by each potential channel
     requestTrans = FlashTransaction();
@@ -105,10 +106,10 @@ bool FrontBuffer::addTransaction(FlashTransaction transaction){
 	    return false;
 	}
     case RETURN_DATA:
-	if(responsesSize <= (RESPONSE_BUFFER_SIZE - (NV_PAGE_SIZE*8)))
+	if(responsesSize <= (RESPONSE_BUFFER_SIZE - (transaction.transferSize()*8)))
 	{
 	    responses.push(transaction);
-	    responsesSize += (NV_PAGE_SIZE*8);
+	    responsesSize += (transaction.transferSize()*8);
 	    return true;
 	}
 	else
@@ -135,7 +136,7 @@ void FrontBuffer::update(void){
     {
 	responseTrans = responses.front();
 	responses.pop();
-	responsesSize = subtract_params(responsesSize, (NV_PAGE_SIZE*8));
+	responsesSize = subtract_params(responsesSize, (responseTrans.transferSize()*8));
 	updateResponse();
     }
     // half duplex case, requests also use the response channel
@@ -177,6 +178,7 @@ void FrontBuffer::update(void){
 	    commandTrans = commands.front();
 	    commands.pop();
 	    requestsSize = subtract_params(requestsSize, COMMAND_LENGTH);
+	    requestSpaceFreed();
 	    updateCommand();
 	}
     }
@@ -194,9 +196,20 @@ FlashTransaction FrontBuffer::newRequestTrans(void){
 	requestsSize = subtract_params(requestsSize, (NV_PAGE_SIZE*8));
     }
     requests.pop();
+    requestSpaceFreed();
     return new_requestTrans;
 }
 
+// let the host know it can try the add that was turned away again
+void FrontBuffer::requestSpaceFreed(void)
+{
+    if(host_waiting)
+    {
+	host_waiting = false;
+	parentNVDIMM->readyToAccept();
+    }
+}
+
 void FrontBuffer::updateResponse(void){
     // first time calling this for this command
     // need to figure out how many cycles we need to move the transaction to the FTL or Hybrid controller
@@ -206,7 +219,7 @@ void FrontBuffer::updateResponse(void){
 	{
 	    // number of channel cycles to go equals the total number of data bits divided by the bits 
 	    // moved per channel cycle
-	    responseCyclesLeft = divide_params_64b((NV_PAGE_SIZE*8), CHANNEL_WIDTH);
+	    responseCyclesLeft = divide_params_64b((responseTrans.transferSize()*8), CHANNEL_WIDTH);
 	}
 	// no request channel to handle request data and commands so we need to handle those cases
 	else if(!ENABLE_REQUEST_CHANNEL)
@@ -405,13 +418,10 @@ FlashTransaction FrontBuffer::findTransaction(std::vector<FlashTransaction> *pen
 // we are done, these functions handle the finish cases
 // done with outgoing data to dies, so add this transaction to the FTL cause the data has been sent
 bool FrontBuffer::sendToFTL(FlashTransaction transaction){
-    return ftl->addTransaction(transaction);
+    return parentNVDIMM->sendToFtl(transaction);
 }
 
 // done with returning data from dies, so initiate a callback 
 void FrontBuffer::sendToHybrid(const FlashTransaction &transaction){
-    if(parentNVDIMM->ReturnReadData!=NULL){
-	(*parentNVDIMM->ReturnReadData)(parentNVDIMM->systemID, transaction.address, currentClockCycle, true);
-    }
-    parentNVDIMM->numReads++;
+    parentNVDIMM->readDone(transaction, currentClockCycle, true);
 }
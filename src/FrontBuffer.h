@@ -80,7 +80,12 @@ namespace NVDSim{
 			Ftl *ftl;
 			NVDIMM *parentNVDIMM;
 
+			// the host had an add turned away for lack of request space
+			bool host_waiting;
+
 		private:
+			void requestSpaceFreed(void);
+
 			int sender;
 			
 			// transaction pointer queues
@@ -42,16 +42,31 @@
 using namespace NVDSim;
 using namespace std;
 
-Ftl::Ftl(Controller *c, Logger *l, NVDIMM *p){
+Ftl::Ftl(Controller *c, Logger *l, NVDIMM *p, uint64_t s){
 	int numBlocks = NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE * BLOCKS_PER_PLANE;
 
+	shard = s;
+
 	channel = 0;
 	die = 0;
 	plane = 0;
+	// other shards start their write pointer on the first plane they own
+	if (!ownsBlock(0))
+	{
+	    inc_ptr();
+	}
 	lookupCounter = 0;
 
 	busy = 0;
 
+	if (FTL_SLOTS == 0)
+	{
+	    ERROR("FTL_SLOTS must be at least 1");
+	    exit(1);
+	}
+	slots = vector<FtlSlot>(FTL_SLOTS, FtlSlot());
+	active_slot = 0;
+
 	addressMap = std::unordered_map<uint64_t, uint64_t>();
 
 	used = vector<vector<bool>>(numBlocks, vector<bool>(PAGES_PER_BLOCK, false));
@@ -69,6 +84,7 @@ Ftl::Ftl(Controller *c, Logger *l, NVDIMM *p){
 	log = l;
 
 	locked_counter = 0;
+	host_waiting = false;
 	
 	saved = false;
 	loaded = false;
@@ -97,6 +113,7 @@ Ftl::Ftl(Controller *c, Logger *l, NVDIMM *p){
 	deadlock_time += ERASE_CYCLES + ((divide_params_64b(COMMAND_LENGTH,DEVICE_WIDTH) * DEVICE_CYCLE) / CYCLE_TIME);
 
 	write_wait_count = DELAY_WRITE_CYCLES;
+	write_draining = false;
 
 	if(ENABLE_WRITE_SCRIPT)
 	{
@@ -150,7 +167,35 @@ ChannelPacket *Ftl::translate(ChannelPacketType type, uint64_t vAddr, uint64_t p
 	physicalAddress /= DIES_PER_PACKAGE;
 	package = physicalAddress % NUM_PACKAGES;
 
-	return new ChannelPacket(type, vAddr, pAddr, page, block, plane, die, package, NULL);
+	ChannelPacket *packet = new ChannelPacket(type, vAddr, pAddr, page, block, plane, die, package, NULL);
+	// the controller schedules on the deadline of whatever this packet is part of
+	packet->deadline = currentTransaction.deadline;
+	packet->tenant = currentTransaction.tenant;
+	packet->hostTimeAdded = currentTransaction.timeAdded;
+	packet->origin = currentTransaction.origin;
+	packet->offset = currentTransaction.offset;
+	packet->size = currentTransaction.size;
+	packet->cache_generation = currentTransaction.cache_generation;
+	return packet;
+}
+
+// data for the current transaction that never has to go to the flash
+FlashTransaction Ftl::returnData(void *data)
+{
+	FlashTransaction ret = currentTransaction;
+	ret.transactionType = RETURN_DATA;
+	ret.data = data;
+	return ret;
+}
+
+bool Ftl::isMapped(uint64_t vAddr)
+{
+	return addressMap.find(vAddr) != addressMap.end();
+}
+
+uint64_t Ftl::readQueueSize(void)
+{
+	return readQueue.size();
 }
 
 bool Ftl::attemptAdd(FlashTransaction &t, std::list<FlashTransaction> *queue, uint64_t queue_limit)
@@ -200,7 +245,7 @@ bool Ftl::addScheduledTransaction(FlashTransaction &t)
 	for (it = writeQueue.begin(); it != writeQueue.end(); it++)
 	{
 	    // don't replace the write if we're already working on it
-	    if((*it).address == t.address && currentTransaction.address != t.address)
+	    if((*it).address == t.address && currentTransaction.address != t.address && !slotConflict(it))
 	    {
 		if(LOGGING)
 		{
@@ -211,9 +256,7 @@ bool Ftl::addScheduledTransaction(FlashTransaction &t)
 		    log->access_stop(t.address, t.address);
 		}
 		// issue a callback for this write
-		if (parent->WriteDataDone != NULL){
-		    (*parent->WriteDataDone)(parent->systemID, (*it).address, currentClockCycle, true);
-		}
+		parent->writeDone(*it, currentClockCycle);
 		writeQueue.erase(it);
 		break;
 	    }
@@ -275,31 +318,36 @@ bool Ftl::addTransaction(FlashTransaction &t){
 void Ftl::scheduleCurrentTransaction(void)
 {
     // do we need to issue a write?
-    if((WRITE_ON_QUEUE_SIZE == true && writeQueue.size() >= WRITE_QUEUE_LIMIT) ||
-       (WRITE_ON_QUEUE_SIZE == false && writeQueue.size() >= FTL_WRITE_QUEUE_LENGTH))
+    bool write_needed;
+    if(ADAPTIVE_WRITE_DRAIN)
     {
-	busy = 1;
-	currentTransaction = writeQueue.front();
-	lookupCounter = LOOKUP_CYCLES;
+	// an unlimited queue has nothing to take a fraction of so the static limit stands in for its size
+	write_draining = parent->writeDrain->drain(write_draining, writeQueue.size(), FTL_WRITE_QUEUE_LENGTH != 0 ? FTL_WRITE_QUEUE_LENGTH : WRITE_QUEUE_LIMIT);
+	write_needed = write_draining;
+    }
+    else
+    {
+	write_needed = (WRITE_ON_QUEUE_SIZE == true && writeQueue.size() >= WRITE_QUEUE_LIMIT) ||
+	    (WRITE_ON_QUEUE_SIZE == false && writeQueue.size() >= FTL_WRITE_QUEUE_LENGTH);
+    }
+    if(write_needed && startTransaction(writeQueue, writeQueue.begin()))
+    {
+	return;
     }
     // no? then issue a read
-    else if (!readQueue.empty()) {
-	    busy = 1;		
-	    currentTransaction = (*read_pointer);
-	    lookupCounter = LOOKUP_CYCLES;
+    if(startTransaction(readQueue, read_pointer))
+    {
+	return;
     }
     // no reads to issue? then issue a write if we have opted to issue writes during idle
-    else if(IDLE_WRITE == true && !writeQueue.empty())
+    if(IDLE_WRITE == true && !writeQueue.empty())
     {
 	if(write_wait_count != 0 && DELAY_WRITE)
 	{
 	    write_wait_count--;				
 	}
-	else
+	else if(startTransaction(writeQueue, writeQueue.begin()))
 	{
-	    busy = 1;
-	    currentTransaction = writeQueue.front();
-	    lookupCounter = LOOKUP_CYCLES;
 	    write_wait_count = DELAY_WRITE_CYCLES;
 	}
     }
@@ -314,28 +362,160 @@ void Ftl::scheduleCurrentTransaction(void)
 void Ftl::scriptCurrentTransaction(void)
 {
     // is it time to issue a write?
-    if(currentClockCycle >= write_cycle && !writeQueue.empty())
+    if(currentClockCycle >= write_cycle && startTransaction(writeQueue, writeQueue.begin()))
     {
-	busy = 1;
-	currentTransaction = writeQueue.front();
-	lookupCounter = LOOKUP_CYCLES;
+	return;
     }
     // no? then issue a read
-    else if(!readQueue.empty())
-    {
-	busy = 1;
-	currentTransaction = readQueue.front();
-	lookupCounter = LOOKUP_CYCLES;
-    }
-    // otherwise do nothing
-    else
+    if(!startTransaction(readQueue, readQueue.begin()))
     {
+	// otherwise do nothing
 	busy = 0;
-	
     }
 }
 
 void Ftl::update(void){
+	updateSlots();
+}
+
+// run one cycle of every ftl slot, each slot gets the members swapped in while it runs
+// so the handlers below only ever see the transaction they are working on
+void Ftl::updateSlots(void)
+{
+	for (active_slot = 0; active_slot < slots.size(); active_slot++)
+	{
+	    loadSlot(active_slot);
+	    updateSlot();
+	    storeSlot(active_slot);
+	}
+}
+
+void Ftl::loadSlot(uint64_t s)
+{
+	currentTransaction = slots[s].transaction;
+	busy = slots[s].busy;
+	lookupCounter = slots[s].lookupCounter;
+	read_queues_full = slots[s].read_queues_full;
+	write_queues_full = slots[s].write_queues_full;
+	queue_access_counter = slots[s].queue_access_counter;
+	reading_write = slots[s].reading_write;
+}
+
+void Ftl::storeSlot(uint64_t s)
+{
+	slots[s].transaction = currentTransaction;
+	slots[s].busy = busy;
+	slots[s].lookupCounter = lookupCounter;
+	slots[s].read_queues_full = read_queues_full;
+	slots[s].write_queues_full = write_queues_full;
+	slots[s].queue_access_counter = queue_access_counter;
+	slots[s].reading_write = reading_write;
+	if (read_queues_full || write_queues_full)
+	{
+	    parent->ftl_waiting = true;
+	}
+	// if the slot let go of its transaction it no longer holds a place in the queue
+	if (!busy)
+	{
+	    slots[s].queue = NULL;
+	}
+}
+
+// true if another slot is already working on this queue entry or on the same address
+// the second check keeps a read from passing a write to the same page and two writes
+// to one page from both marking the old copy dirty
+bool Ftl::slotConflict(std::list<FlashTransaction>::iterator it)
+{
+	for (uint64_t s = 0; s < slots.size(); s++)
+	{
+	    if (s == active_slot || !slots[s].busy || slots[s].queue == NULL)
+		continue;
+	    if (slots[s].entry == it || slots[s].transaction.address == (*it).address)
+		return true;
+	}
+	return false;
+}
+
+// hand the active slot the first transaction from start onwards (wrapping around) that no other slot is working on
+// the transaction stays in its queue until the slot pops it so the queue lengths look the same as with one slot
+bool Ftl::startTransaction(std::list<FlashTransaction> &queue, std::list<FlashTransaction>::iterator start)
+{
+	if (queue.empty())
+	    return false;
+	std::list<FlashTransaction>::iterator it = start;
+	for (uint64_t i = 0; i < queue.size(); i++)
+	{
+	    if (it == queue.end())
+		it = queue.begin();
+	    if (!slotConflict(it))
+	    {
+		busy = 1;
+		currentTransaction = (*it);
+		lookupCounter = LOOKUP_CYCLES;
+		slots[active_slot].queue = &queue;
+		slots[active_slot].entry = it;
+		return true;
+	    }
+	    it++;
+	}
+	return false;
+}
+
+// with more than one slot or with deadlines the transaction being finished isn't necessarily at the front of its queue
+// so remove the exact entry the active slot was given
+void Ftl::popSlot(void)
+{
+	std::list<FlashTransaction> *queue = slots[active_slot].queue;
+	queue->erase(slots[active_slot].entry);
+	slots[active_slot].queue = NULL;
+	if (queue == &readQueue)
+	{
+	    // same as a normal pop, go back to trying the front of the read queue
+	    read_pointer = readQueue.begin();
+	}
+	if(LOGGING && QUEUE_EVENT_LOG && (queue == &readQueue || queue == &writeQueue))
+	{
+	    log->log_ftl_queue_event(queue == &writeQueue, queue);
+	}
+}
+
+// earliest deadline first across both queues
+// transactions without a deadline never win here so they only get what the deadlines leave over
+bool Ftl::startDeadlineTransaction(void)
+{
+	std::list<FlashTransaction> *queue = &readQueue;
+	std::list<FlashTransaction>::iterator best = earliestDeadline(readQueue);
+	std::list<FlashTransaction>::iterator write = earliestDeadline(writeQueue);
+	if (write != writeQueue.end() && (best == readQueue.end() || (*write).deadline < (*best).deadline))
+	{
+	    queue = &writeQueue;
+	    best = write;
+	}
+	if (best == queue->end())
+	{
+	    return false;
+	}
+	return startTransaction(*queue, best);
+}
+
+// nothing may pass an older transaction to the same address in its own queue
+// otherwise a read could get ahead of the write it should see or two writes could land out of order
+std::list<FlashTransaction>::iterator Ftl::earliestDeadline(std::list<FlashTransaction> &queue)
+{
+	std::list<FlashTransaction>::iterator best = queue.end(), it, older;
+	for (it = queue.begin(); it != queue.end(); it++)
+	{
+	    if ((*it).deadline == 0 || (best != queue.end() && (*it).deadline >= (*best).deadline) || slotConflict(it))
+		continue;
+	    for (older = queue.begin(); older != it && (*older).address != (*it).address; older++)
+		;
+	    if (older == it)
+		best = it;
+	}
+	return best;
+}
+
+void Ftl::updateSlot(void){
 	if (busy) {
 	    if (lookupCounter <= 0 && !write_queues_full){
 			switch (currentTransaction.transactionType){
@@ -366,29 +546,29 @@ void Ftl::update(void){
 	    }
 	} // Not currently busy.
 	else {
-	    // we're favoring reads over writes so we need to check the write queues to make sure they
-	    // aren't filling up. if they are we issue a write, otherwise we just keeo on issuing reads
-	    if(SCHEDULE || PERFECT_SCHEDULE)
+	    // anything with a deadline gets the slot first, the policies below only see what's left
+	    if(!(DEADLINE_SCHEDULE && startDeadlineTransaction()))
 	    {
-		if(ENABLE_WRITE_SCRIPT)
+		// we're favoring reads over writes so we need to check the write queues to make sure they
+		// aren't filling up. if they are we issue a write, otherwise we just keeo on issuing reads
+		if(SCHEDULE || PERFECT_SCHEDULE)
 		{
-		    // use the script to determine whether we're issuing a write here
-		    scriptCurrentTransaction();
+		    if(ENABLE_WRITE_SCRIPT)
+		    {
+			// use the script to determine whether we're issuing a write here
+			scriptCurrentTransaction();
+		    }
+		    else
+		    {
+			// schedule the next transaction
+			scheduleCurrentTransaction();
+		    }
 		}
+		// we're not scheduling so everything is in the read queue
+		// just issue from there
 		else
 		{
-		    // schedule the next transaction
-		    scheduleCurrentTransaction();
-		}
-	    }
-	    // we're not scheduling so everything is in the read queue
-	    // just issue from there
-	    else
-	    {
-		if (!readQueue.empty()) {
-		    busy = 1;
-		    currentTransaction = readQueue.front();
-		    lookupCounter = LOOKUP_CYCLES;
+		    startTransaction(readQueue, readQueue.begin());
 		}
 	    }
 	}
@@ -414,6 +594,8 @@ void Ftl::handle_disk_read(bool gc)
     // Search from the current write pointer to the end of the flash for a free page.
     for (block = start ; block < TOTAL_SIZE / BLOCK_SIZE && !done; block++)
     {
+	if (!ownsBlock(block))
+	    continue;
 	for (page = 0 ; page < PAGES_PER_BLOCK  && !done ; page++)
 	{
 	    if (!used[block][page])
@@ -432,6 +614,8 @@ void Ftl::handle_disk_read(bool gc)
     {							
 	for (block = 0 ; block < start / BLOCK_SIZE && !done; block++)
 	{
+	    if (!ownsBlock(block))
+		continue;
 	    for (page = 0 ; page < PAGES_PER_BLOCK  && !done; page++)
 	    {
 		if (!used[block][page])
@@ -474,12 +658,7 @@ void Ftl::handle_disk_read(bool gc)
 	addressMap[vAddr] = pAddr;
 	
 	//update "write pointer"
-	channel = (channel + 1) % NUM_PACKAGES;
-	if (channel == 0){
-	    die = (die + 1) % DIES_PER_PACKAGE;
-	    if (die == 0)
-		plane = (plane + 1) % PLANES_PER_DIE;
-	}
+	inc_ptr();
 	//=============================================================================
 	// the read part
 	//=============================================================================    
@@ -580,7 +759,7 @@ void Ftl::handle_read(bool gc)
 		    log->access_stop(vAddr, vAddr);
 		}
 
-		controller->returnReadData(FlashTransaction(RETURN_DATA, vAddr, (*reading_write).data));
+		controller->returnReadData(returnData((*reading_write).data));
 		
 		if(LOGGING && QUEUE_EVENT_LOG)
 		{
@@ -628,7 +807,7 @@ void Ftl::handle_read(bool gc)
 		    }
 
 		    // Miss, nothing to read so return garbage.
-		    controller->returnUnmappedData(FlashTransaction(RETURN_DATA, vAddr, (void *)0xdeadbeef));
+		    controller->returnUnmappedData(returnData((void *)0xdeadbeef));
 	       
 		    popFront(READ);
 		    read_iterator_counter = 0;
@@ -748,6 +927,8 @@ void Ftl::handle_scripted_write(void)
     // Search from the current write pointer to the end of the flash for a free page.
     for (block = start; block < stop && !done; block++)
     {
+	if (!ownsBlock(block))
+	    continue;
 	for (page = 0 ; page < PAGES_PER_BLOCK  && !done ; page++)
 	{
 	    if (!used[block][page])
@@ -820,7 +1001,7 @@ void Ftl::handle_write(bool gc)
     ChannelPacket *commandPacket, *dataPacket;
     bool done = false;
     bool finished = false;
-    uint64_t block, page, tmp_block, tmp_page;
+    uint64_t block = 0, page = 0;
 
     temp_channel = channel;
     temp_die = die;
@@ -849,47 +1030,10 @@ void Ftl::handle_write(bool gc)
 	{ 	    
 	    //look for first free physical page starting at the write pointer
 	    start = BLOCKS_PER_PLANE * (temp_plane + PLANES_PER_DIE * (temp_die + DIES_PER_PACKAGE * temp_channel));
-	    
-	    // Search from the current write pointer to the end of the flash for a free page.
-	    for (block = start ; block < TOTAL_SIZE / BLOCK_SIZE && !done; block++)
-	    {
-		for (page = 0 ; page < PAGES_PER_BLOCK  && !done ; page++)
-		{
-		    if (!used[block][page])
-		    {
-			tmp_block = block;
-			tmp_page = page;
-			pAddr = (block * BLOCK_SIZE + page * NV_PAGE_SIZE);
-			done = true;
-		    }
-		}
-	    }
-	    block = tmp_block;
-	    page = tmp_page;
+	    done = findFreePage(start, block, page);
+	    pAddr = (block * BLOCK_SIZE + page * NV_PAGE_SIZE);
 	    //attemptWrite(start, &vAddr, &pAddr, &done);
 	    
-	    
-	    // If we didn't find a free page after scanning to the end. Scan from the beginning
-	    // to the write pointer
-	    if (!done)
-	    {							
-		for (block = 0 ; block < start / BLOCK_SIZE && !done; block++)
-		{
-		    for (page = 0 ; page < PAGES_PER_BLOCK  && !done; page++)
-		    {
-			if (!used[block][page])
-			{
-			    tmp_block = block;
-			    tmp_page = page;
-			    pAddr = (block * BLOCK_SIZE + page * NV_PAGE_SIZE);
-			    done = true;
-			}
-		    }
-		}
-		block = tmp_block;
-		page = tmp_page;
-	    }
-	    
 	    if (!done)
 	    {
 		deadlock_counter++;
@@ -922,12 +1066,7 @@ void Ftl::handle_write(bool gc)
 		if(PERFECT_SCHEDULE)
 		{
 		    //update "write pointer"
-		    channel = (channel + 1) % NUM_PACKAGES;
-		    if (channel == 0){
-			die = (die + 1) % DIES_PER_PACKAGE;
-			if (die == 0)
-			    plane = (plane + 1) % PLANES_PER_DIE;
-		    }
+		    inc_ptr();
 
 		    // made this a function cause the code was repeated a bunch of places
 		    write_success(block, page, vAddr, pAddr, gc, mapped);
@@ -943,9 +1082,7 @@ void Ftl::handle_write(bool gc)
 		    
 		    // Now the write is done cause we're not actually issuing them.
 		    //call write callback
-		    if (parent->WriteDataDone != NULL){
-			(*parent->WriteDataDone)(parent->systemID, vAddr, currentClockCycle, true);
-		    }
+		    parent->writeDone(currentTransaction, currentClockCycle);
 		    finished = true;
 		}
 		// not perfect scheduling
@@ -1005,12 +1142,7 @@ void Ftl::handle_write(bool gc)
 			if(itr_count == 0)
 			{
 			    //update "write pointer"
-			    channel = (channel + 1) % NUM_PACKAGES;
-			    if (channel == 0){
-				die = (die + 1) % DIES_PER_PACKAGE;
-				if (die == 0)
-				    plane = (plane + 1) % PLANES_PER_DIE;
-			    }
+			    inc_ptr();
 			}
 			finished = true;
 		    }
@@ -1020,16 +1152,93 @@ void Ftl::handle_write(bool gc)
     }
 }
 
+// where the write the ftl is working on goes, false if there is nowhere for it right now
+// the page mapped ftls take the first free page from the write pointer on
+bool Ftl::findFreePage(uint64_t start, uint64_t &block, uint64_t &page)
+{
+    bool done = false;
+    uint64_t b, p;
+
+    // Search from the current write pointer to the end of the flash for a free page.
+    for (b = start ; b < TOTAL_SIZE / BLOCK_SIZE && !done; b++)
+    {
+	if (!ownsBlock(b))
+	    continue;
+	for (p = 0 ; p < PAGES_PER_BLOCK  && !done ; p++)
+	{
+	    if (!used[b][p])
+	    {
+		block = b;
+		page = p;
+		done = true;
+	    }
+	}
+    }
+
+    // If we didn't find a free page after scanning to the end. Scan from the beginning
+    // to the write pointer
+    if (!done)
+    {							
+	for (b = 0 ; b < start / BLOCK_SIZE && !done; b++)
+	{
+	    if (!ownsBlock(b))
+		continue;
+	    for (p = 0 ; p < PAGES_PER_BLOCK  && !done; p++)
+	    {
+		if (!used[b][p])
+		{
+		    block = b;
+		    page = p;
+		    done = true;
+		}
+	    }
+	}
+    }
+    return done;
+}
+
 uint64_t Ftl::get_ptr(void) {
 	// Return a pointer to the current plane.
 	return NV_PAGE_SIZE * PAGES_PER_BLOCK * BLOCKS_PER_PLANE * 
 		(plane + PLANES_PER_DIE * (die + NUM_PACKAGES * channel));
 }
 
+void Ftl::inc_ptr(void) {
+	// with shards keep going until we get to a plane this shard owns
+	do
+	{
+	    // with multi-plane ops fill the planes of a die before moving on so that back to back
+	    // writes land on the same page of neighboring planes and the controller can merge them
+	    if (MULTI_PLANE)
+	    {
+		plane = (plane + 1) % PLANES_PER_DIE;
+		if (plane == 0){
+		    channel = (channel + 1) % NUM_PACKAGES;
+		    if (channel == 0)
+			die = (die + 1) % DIES_PER_PACKAGE;
+		}
+	    }
+	    else
+	    {
+		channel = (channel + 1) % NUM_PACKAGES;
+		if (channel == 0){
+		    die = (die + 1) % DIES_PER_PACKAGE;
+		    if (die == 0)
+			plane = (plane + 1) % PLANES_PER_DIE;
+		}
+	    }
+	} while (!ownsBlock(BLOCKS_PER_PLANE * (plane + PLANES_PER_DIE * (die + DIES_PER_PACKAGE * channel))));
+}
+
 void Ftl::popFront(ChannelPacketType type)
 {
+    // earliest deadline first can start anything in the queue, not just the front
+    if(slots.size() > 1 || DEADLINE_SCHEDULE)
+    {
+	popSlot();
+    }
     // if we've put stuff into different queues we must now figure out which queue to pop from
-    if(SCHEDULE || PERFECT_SCHEDULE)
+    else if(SCHEDULE || PERFECT_SCHEDULE)
     {
 	if(type == READ || type == ERASE)
 	{
@@ -1061,6 +1270,7 @@ void Ftl::popFront(ChannelPacketType type)
 	    log->log_ftl_queue_event(false, &readQueue);
 	}
     }
+    hostQueuePopped();
 }
 
 void Ftl::powerCallback(void) 
@@ -1226,11 +1436,51 @@ void Ftl::queuesNotFull(void)
 {
     read_queues_full = false;
     write_queues_full = false;   
-    log->unlocked_up(locked_counter);
+    // every slot that was stalled on a full controller queue can try again
+    for (uint64_t s = 0; s < slots.size(); s++)
+    {
+	slots[s].read_queues_full = false;
+	slots[s].write_queues_full = false;
+    }
+    if(LOGGING)
+    {
+	log->unlocked_up(locked_counter);
+    }
     locked_counter = 0;
 }
 
+// a read or write queue entry just went away so there is room for whatever the host was holding
+void Ftl::hostQueuePopped(void)
+{
+    if(host_waiting)
+    {
+	host_waiting = false;
+	parent->readyToAccept();
+    }
+}
+
 void Ftl::GCReadDone(uint64_t vAddr)
 {
     // an empty fucntion to make the compiler happy
 }
+
+void Ftl::packedWriteDone(uint64_t pAddr, uint64_t cycle)
+{
+    // only the sector mapped ftl packs writes
+}
+
+void Ftl::mapReadDone(uint64_t vAddr)
+{
+    // only the demand paged ftl keeps its map in the flash
+}
+
+void Ftl::eraseDone(void)
+{
+    // only the gc ftl keeps track of its erases
+}
+
+// with FTL_SHARDS whole planes are dealt out round robin so the shards never fight over a plane
+bool Ftl::ownsBlock(uint64_t block)
+{
+    return ((block / BLOCKS_PER_PLANE) % FTL_SHARDS) == shard;
+}
@@ -51,9 +51,12 @@ namespace NVDSim{
         class NVDIMM;
 	class Ftl : public SimObj{
 		public:
-	                Ftl(Controller *c, Logger *l, NVDIMM *p);
+	                Ftl(Controller *c, Logger *l, NVDIMM *p, uint64_t s);
 
 			ChannelPacket *translate(ChannelPacketType type, uint64_t vAddr, uint64_t pAddr);
+			FlashTransaction returnData(void *data);
+			bool isMapped(uint64_t vAddr);
+			uint64_t readQueueSize(void);
 			bool attemptAdd(FlashTransaction &t, std::list<FlashTransaction> *queue, uint64_t queue_limit);
 			bool addScheduledTransaction(FlashTransaction &t);
 			bool addPerfectTransaction(FlashTransaction &t);
@@ -61,12 +64,16 @@ namespace NVDSim{
 			void scriptCurrentTransaction(void);
 			void scheduleCurrentTransaction(void);
 			virtual void update(void);
+			virtual void updateSlot(void);
+			bool startTransaction(std::list<FlashTransaction> &queue, std::list<FlashTransaction>::iterator start);
+			bool startDeadlineTransaction(void);
 			void handle_disk_read(bool gc);
 			void handle_read(bool gc);
 			virtual void write_used_handler(uint64_t vAddr);
-			void write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped);
+			virtual void write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped);
 			void handle_scripted_write(void);
 			void handle_write(bool gc);
+			virtual bool findFreePage(uint64_t start, uint64_t &block, uint64_t &page);
 			uint64_t get_ptr(void); 
 			void inc_ptr(void); 
 
@@ -80,14 +87,26 @@ namespace NVDSim{
 			virtual void loadNVState(void);
 
 			void queuesNotFull(void);
+			// the host had an add turned away by this ftl
+			bool host_waiting;
 			void flushWriteQueues(void);
 
 			virtual void GCReadDone(uint64_t vAddr);
+			virtual void eraseDone(void);
+			// a program of several host sectors packed into one page finished, see SECTOR_MAPPING
+			virtual void packedWriteDone(uint64_t pAddr, uint64_t cycle);
+			// a page of the mapping table came back from the flash, see DFTL
+			virtual void mapReadDone(uint64_t vAddr);
+
+			bool ownsBlock(uint64_t block);
 		       
 			Controller *controller;
 
 			NVDIMM *parent;
 
+			// which shard of the address space this ftl looks after
+			uint64_t shard;
+
 			Logger *log;
 
 			// temp stuff **************************
@@ -95,6 +114,14 @@ namespace NVDSim{
 			// *************************************
 
 		protected:
+			void updateSlots(void);
+			void loadSlot(uint64_t s);
+			void storeSlot(uint64_t s);
+			bool slotConflict(std::list<FlashTransaction>::iterator it);
+			std::list<FlashTransaction>::iterator earliestDeadline(std::list<FlashTransaction> &queue);
+			void popSlot(void);
+			void hostQueuePopped(void);
+
 			std::ifstream scriptfile;
 			uint64_t write_cycle;
 			uint64_t write_addr;
@@ -115,6 +142,7 @@ namespace NVDSim{
 			uint64_t write_counter;
 			uint64_t used_page_count;
 			uint64_t write_wait_count;
+			bool write_draining; // only used with ADAPTIVE_WRITE_DRAIN
 			std::list<FlashTransaction>::iterator read_pointer; // stores location of the last place we tried in the read queue
 
 			bool saved;
@@ -131,6 +159,34 @@ namespace NVDSim{
 			std::vector<vector<bool>> used;
 			std::list<FlashTransaction> readQueue; 
 			std::list<FlashTransaction> writeQueue;
+
+			// everything one transaction needs while the ftl works on it
+			// update() swaps each slot in and out of the members above so the handlers don't need to know about slots
+			class FtlSlot
+			{
+			public:
+			    FlashTransaction transaction;
+			    bool busy;
+			    uint64_t lookupCounter;
+			    bool read_queues_full;
+			    bool write_queues_full;
+			    uint64_t queue_access_counter;
+			    std::list<FlashTransaction>::iterator reading_write;
+			    std::list<FlashTransaction> *queue; // the queue the transaction is still sitting in
+			    std::list<FlashTransaction>::iterator entry;
+
+			    FtlSlot()
+			    {
+				busy = false;
+				lookupCounter = 0;
+				read_queues_full = false;
+				write_queues_full = false;
+				queue_access_counter = 0;
+				queue = NULL;
+			    }
+			};
+			std::vector<FtlSlot> slots;
+			uint64_t active_slot;
 	};
 }
 #endif
@@ -42,14 +42,16 @@
 using namespace NVDSim;
 using namespace std;
 
-GCFtl::GCFtl(Controller *c, Logger *l, NVDIMM *p) 
-    : Ftl(c, l, p)
+GCFtl::GCFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s) 
+    : Ftl(c, l, p, s)
 {	
         int numBlocks = NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE * BLOCKS_PER_PLANE;
 
 	used_page_count = 0;
 	gc_status = 0;
 	panic_mode = 0;
+	erase_count = 0;
+	panic_erases = 0;
 
 	dirty_page_count = 0;
 
@@ -91,6 +93,10 @@ void GCFtl::addGcTransaction(FlashTransaction &t){
     // we use a special GC queue whether we're scheduling or not so always just do it like this
     gcQueue.push_back(t);
     write_queues_full = false;
+    for (uint64_t s = 0; s < slots.size(); s++)
+    {
+	slots[s].write_queues_full = false;
+    }
     
     if(LOGGING == true)
     {
@@ -102,33 +108,55 @@ void GCFtl::addGcTransaction(FlashTransaction &t){
 void GCFtl::update(void){
 	uint64_t i;
 	if (gc_status){
-		if (!panic_mode && parent->numErases == start_erase + 1)
+		if (!panic_mode && erase_count == start_erase + 1)
 			gc_status = 0;
-		if (panic_mode && parent->numErases == start_erase + PLANES_PER_DIE * DIES_PER_PACKAGE * NUM_PACKAGES){
+		if (panic_mode && erase_count == start_erase + panic_erases){
 			panic_mode = 0;
 			gc_status = 0;
 		}
 	}
 
-	if (!gc_status && (float)used_page_count >= (float)(FORCE_GC_THRESHOLD * (VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE))){
-	    if(dirty_page_count != 0)
+	if (!gc_status && (float)used_page_count >= (float)(FORCE_GC_THRESHOLD * (VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE / FTL_SHARDS))){
+	    if(hasGarbage())
 	    {
-		start_erase = parent->numErases;
+		start_erase = erase_count;
 		gc_status = 1;
 		panic_mode = 1;
-		busy = 0;
+		// drop whatever the slots were working on, it is all still in the queues
+		for (i = 0; i < slots.size(); i++)
+		{
+			slots[i].busy = 0;
+			slots[i].queue = NULL;
+		}
+		// one erase on every plane this ftl owns
+		panic_erases = 0;
 		for (i = 0 ; i < PLANES_PER_DIE * DIES_PER_PACKAGE * NUM_PACKAGES; i++)
 		{
-			runGC(i);
+			if (ownsBlock(i * BLOCKS_PER_PLANE))
+			{
+				runGC(i);
+				panic_erases++;
+			}
 		}
 	    }
-	    else if((float)used_page_count >= (float)(VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE))
+	    else if((float)used_page_count >= (float)(VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE / FTL_SHARDS))
 	    {
 		ERROR("FLASH DIMM IS FULL OF USED PAGES AND NONE OF THEM ARE DIRTY - there is nothing the gc can do.");
 		exit(7001);
 	    }
 	}
 
+	updateSlots();
+
+	//place power callbacks to hybrid_system
+#if Verbose_Power_Callback
+	  controller->returnPowerData(idle_energy, access_energy, erase_energy);
+#endif
+
+}
+
+void GCFtl::updateSlot(void){
+	uint64_t i;
 	if (busy) {
 	    if (lookupCounter <= 0 && !write_queues_full){
 			uint64_t vAddr = currentTransaction.address;
@@ -174,7 +202,12 @@ void GCFtl::update(void){
 							used_page_count--;
 						}
 					    }
-					    if(gc_status)
+					    blockErased(vAddr / BLOCK_SIZE);
+					    if(slots.size() > 1 || DEADLINE_SCHEDULE)
+					    {
+						popSlot();
+					    }
+					    else if(gc_status)
 					    {
 						gcQueue.pop_front();
 					    }
@@ -211,46 +244,40 @@ void GCFtl::update(void){
 	    // if we're doing gc stuff then everything should be coming from the gc queue
 	    if(gc_status)
 	    {
-		if (!gcQueue.empty()) {
-		    busy = 1;
-		    currentTransaction = gcQueue.front();
-		    lookupCounter = LOOKUP_CYCLES;
-		}
-		// do nothing
-		else
+		// do nothing if there isn't anything
+		if (!startTransaction(gcQueue, gcQueue.begin()))
 		{
 		    busy = 0;
 		}
 	    }
-	    // if we're not in gc mode and...
-	    // we're favoring reads over writes so we need to check the write queues to make sure they
-	    // aren't filling up. if they are we issue a write, otherwise we just keeo on issuing reads
-	    else if(SCHEDULE || PERFECT_SCHEDULE)
+	    // anything with a deadline gets the slot first, the policies below only see what's left
+	    else if(!(DEADLINE_SCHEDULE && startDeadlineTransaction()))
 	    {
-		if(ENABLE_WRITE_SCRIPT)
-		{
-		    scriptCurrentTransaction();
-		}
-		// standard scheduling
-		else
+		// if we're not in gc mode and...
+		// we're favoring reads over writes so we need to check the write queues to make sure they
+		// aren't filling up. if they are we issue a write, otherwise we just keeo on issuing reads
+		if(SCHEDULE || PERFECT_SCHEDULE)
 		{
-		    // schedule the next transaction using the scheduler algorithm in Ftl.cpp
-		    scheduleCurrentTransaction();
-		}
+		    if(ENABLE_WRITE_SCRIPT)
+		    {
+			scriptCurrentTransaction();
+		    }
+		    // standard scheduling
+		    else
+		    {
+			// schedule the next transaction using the scheduler algorithm in Ftl.cpp
+			scheduleCurrentTransaction();
+		    }
 
-	    }
-	     // we're not scheduling so everything is in the read queue
-	    // just issue from there
-	    else {
-		if (!readQueue.empty()) {
-		    busy = 1;
-		    currentTransaction = readQueue.front();
-		    lookupCounter = LOOKUP_CYCLES;
 		}
-		// do nothing
-		else
-		{
-		    busy = 0;
+		 // we're not scheduling so everything is in the read queue
+		// just issue from there
+		else {
+		    // do nothing if there isn't anything
+		    if (!startTransaction(readQueue, readQueue.begin()))
+		    {
+			busy = 0;
+		    }
 		}
 	    }
 
@@ -258,20 +285,14 @@ void GCFtl::update(void){
 	    // Check to see if GC needs to run.
 	    // just using lookupCounter here as an indicator or whether or not something was done 
 	    // before we got here
-	    if (lookupCounter != LOOKUP_CYCLES && checkGC() && !gc_status && dirty_page_count != 0)
+	    if (lookupCounter != LOOKUP_CYCLES && checkGC() && !gc_status && hasGarbage())
 	    {
 		// Run the GC.
-		start_erase = parent->numErases;
+		start_erase = erase_count;
 		gc_status = 1;
 		runGC();
 	    }
 	}
-
-	//place power callbacks to hybrid_system
-#if Verbose_Power_Callback
-	  controller->returnPowerData(idle_energy, access_energy, erase_energy);
-#endif
-
 }
 
 void GCFtl::write_used_handler(uint64_t vAddr)
@@ -282,25 +303,22 @@ void GCFtl::write_used_handler(uint64_t vAddr)
 
 bool GCFtl::checkGC(void){
 	// Return true if more than 70% of blocks are in use and false otherwise.
-        if ((float)used_page_count > ((float)IDLE_GC_THRESHOLD * (VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE)))
+        if ((float)used_page_count > ((float)IDLE_GC_THRESHOLD * (VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE / FTL_SHARDS)))
 		return true;
 	return false;
 }
 
 
 void GCFtl::runGC() {
-  uint64_t block, page, count, dirty_block=0, dirty_count=0;
+  uint64_t block, count, dirty_block=shard * BLOCKS_PER_PLANE, dirty_count=0;
 	FlashTransaction trans;
 	PendingErase temp_erase;
 	cout << "normal gc running \n";
 	// Get the dirtiest block (assumes the flash keeps track of this with an online algorithm).
 	for (block = erase_pointer; block < TOTAL_SIZE / BLOCK_SIZE; block++) {
-	  count = 0;
-	  for (page = 0; page < PAGES_PER_BLOCK; page++) {
-		if (dirty[block][page] == true) {
-			count++;
-		}
-	  }
+	  if (!ownsBlock(block))
+	      continue;
+	  count = garbage(block);
 	  if (count > dirty_count) {
 	      	dirty_count = count;
 	       	dirty_block = block;
@@ -315,19 +333,17 @@ void GCFtl::runGC() {
 // if we are in panic mode then the system is dangerously full, we need to make as much clean space as possible
 // so we will erase a block on every independent plane at the same time
 void GCFtl::runGC(uint64_t plane) {
-  uint64_t block, page, count, dirty_block=0, dirty_count=0;
+  uint64_t block, count, dirty_block, dirty_count=0;
   cout << "panic mode gc running \n";
 	FlashTransaction trans;
 	PendingErase temp_erase;
 
+	// if nothing on this plane is dirty fall back to its first block
+	dirty_block = plane * BLOCKS_PER_PLANE;
+
 	// Get the dirtiest block (assumes the flash keeps track of this with an online algorithm).
 	for (block = (plane * BLOCKS_PER_PLANE); block < ((plane + 1) * BLOCKS_PER_PLANE); block++) {
-	  count = 0;
-	  for (page = 0; page < PAGES_PER_BLOCK; page++) {
-		if (dirty[block][page] == true) {
-			count++;
-		}
-	  }
+	  count = garbage(block);
 	  if (count > dirty_count) {
 	      	dirty_count = count;
 	       	dirty_block = block;
@@ -337,6 +353,27 @@ void GCFtl::runGC(uint64_t plane) {
 	addGC(dirty_block);
 }
 
+uint64_t GCFtl::garbage(uint64_t block)
+{
+    uint64_t page, count = 0;
+    for (page = 0; page < PAGES_PER_BLOCK; page++) {
+	if (dirty[block][page] == true) {
+	    count++;
+	}
+    }
+    return count;
+}
+
+bool GCFtl::hasGarbage(void)
+{
+    return dirty_page_count != 0;
+}
+
+void GCFtl::blockErased(uint64_t block)
+{
+    // the dirty and used tables are already taken care of in updateSlot
+}
+
 // the guts of the runGC function separated out to prevent duplicated code
 // this adds the read GC transactions if there are any and creates a pending erase entry
 void GCFtl::addGC(uint64_t dirty_block)
@@ -389,8 +426,13 @@ void GCFtl::addGC(uint64_t dirty_block)
 
 void GCFtl::popFront(ChannelPacketType type)
 {
+    // earliest deadline first can start anything in the queue, not just the front
+    if(slots.size() > 1 || DEADLINE_SCHEDULE)
+    {
+	popSlot();
+    }
     // if its a gc operation pop from the gc queue
-    if(type == ERASE || type == GC_READ || type == GC_WRITE)
+    else if(type == ERASE || type == GC_READ || type == GC_WRITE)
     {
 	gcQueue.pop_front();
     }
@@ -423,6 +465,11 @@ void GCFtl::popFront(ChannelPacketType type)
     {
 	readQueue.pop_front();
     }
+    // gc operations never took up any of the host's room
+    if(type != ERASE && type != GC_READ && type != GC_WRITE)
+    {
+	hostQueuePopped();
+    }
 }
 
 void GCFtl::sendQueueLength(void)
@@ -601,7 +648,9 @@ void GCFtl::loadNVState(void)
     }
 }
 
-void GCFtl::GCReadDone(uint64_t vAddr)
+// takes a finished gc read off of the erase that was waiting on it
+// returns true if that was the last read that erase was waiting on
+bool GCFtl::gcReadFinished(uint64_t vAddr, uint64_t &erase_block)
 {
    list<PendingErase>::iterator it;
     for (it = gc_pending_erase.begin(); it != gc_pending_erase.end(); it++)
@@ -610,13 +659,28 @@ void GCFtl::GCReadDone(uint64_t vAddr)
 
 	if((*it).pending_reads.empty())
 	{
-	    FlashTransaction trans = FlashTransaction(BLOCK_ERASE, (*it).erase_block * BLOCK_SIZE, NULL); 
-	    addGcTransaction(trans);
+	    erase_block = (*it).erase_block;
 	    gc_pending_erase.erase(it);
-	    break;
+	    return true;
 	}
     } 
+    return false;
+}
+
+void GCFtl::GCReadDone(uint64_t vAddr)
+{
+   uint64_t erase_block;
+   if(gcReadFinished(vAddr, erase_block))
+   {
+       FlashTransaction trans = FlashTransaction(BLOCK_ERASE, erase_block * BLOCK_SIZE, NULL); 
+       addGcTransaction(trans);
+   }
 
    FlashTransaction trans = FlashTransaction(GC_DATA_WRITE, vAddr, NULL);
    addGcTransaction(trans);
 }
+
+void GCFtl::eraseDone(void)
+{
+    erase_count++;
+}
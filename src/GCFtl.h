@@ -51,15 +51,19 @@ namespace NVDSim{
         class NVDIMM;
 	class GCFtl : public Ftl{
 		public:
-	                GCFtl(Controller *c, Logger *l, NVDIMM *p);
+	                GCFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s);
 			bool addTransaction(FlashTransaction &t);
 			void addGcTransaction(FlashTransaction &t);
 			void update(void);
+			void updateSlot(void);
 			void write_used_handler(uint64_t vAddr);
 			bool checkGC(void); 
 			void runGC(void);
 			void runGC(uint64_t plane);
-			void addGC(uint64_t dirty_block);
+			virtual void addGC(uint64_t dirty_block);
+			// how much of a block the gc would get back by erasing it, used to pick the victim
+			virtual uint64_t garbage(uint64_t block);
+			virtual bool hasGarbage(void);
 
 			void popFront(ChannelPacketType type);
 
@@ -69,10 +73,17 @@ namespace NVDSim{
 			void loadNVState(void);
 
 			void GCReadDone(uint64_t vAddr);
+			void eraseDone(void);
 
 		protected:
+			bool gcReadFinished(uint64_t vAddr, uint64_t &erase_block);
+			// called once an erase of the block has been sent and its pages are free again
+			virtual void blockErased(uint64_t block);
+
 			bool gc_status, panic_mode;
 			uint64_t start_erase;
+			uint64_t erase_count; // erases of this ftl's blocks that have finished
+			uint64_t panic_erases;
 
 			uint64_t erase_pointer;			
 			
@@ -49,6 +49,21 @@ namespace NVDSim
     bool CTRL_WRITE_ON_QUEUE_SIZE;
     uint64_t CTRL_WRITE_QUEUE_LIMIT;
     bool CTRL_IDLE_WRITE;
+    bool CTRL_OUT_OF_ORDER;
+    uint64_t CTRL_OOO_WINDOW;
+    uint64_t CTRL_OOO_AGE_CAP;
+    bool DEADLINE_SCHEDULE;
+    std::string TENANT_WEIGHTS;
+    uint64_t TENANT_QUEUE_LENGTH;
+    bool ADAPTIVE_WRITE_DRAIN;
+    float DRAIN_HIGH_WATERMARK;
+    float DRAIN_LOW_WATERMARK;
+    uint64_t DRAIN_WINDOW;
+    bool MULTI_PLANE;
+    bool CACHE_MODE;
+    bool ERASE_SUSPEND;
+    bool PROGRAM_SUSPEND;
+    uint64_t MAX_SUSPENDS;
     bool PERFECT_SCHEDULE;
     bool ENABLE_WRITE_SCRIPT;
     std::string NV_WRITE_SCRIPT;
@@ -63,18 +78,56 @@ namespace NVDSim
     bool CUT_THROUGH;
     uint64_t IN_BUFFER_SIZE;
     uint64_t OUT_BUFFER_SIZE;
+    bool READ_CACHE;
+    uint64_t READ_CACHE_SIZE;
+    uint64_t READ_CACHE_LINE_SIZE;
+    uint64_t READ_CACHE_WAYS;
+    std::string READ_CACHE_POLICY;
+    uint64_t READ_CACHE_HIT_LATENCY;
+    bool WRITE_BUFFER;
+    uint64_t WRITE_BUFFER_PAGES;
+    uint64_t WRITE_BUFFER_LINE_SIZE;
+    uint64_t WRITE_BUFFER_MAX_AGE;
+    uint64_t WRITE_BUFFER_LATENCY;
+    bool PREFETCH;
+    uint64_t PREFETCH_STREAMS;
+    uint64_t PREFETCH_TRIGGER;
+    uint64_t PREFETCH_DEPTH;
+    float PREFETCH_QUEUE_OCCUPANCY;
     
     bool CRIT_LINE_FIRST;
+
+    bool PARTIAL_READS;
+    uint64_t SECTOR_SIZE;
+
+    bool SECTOR_MAPPING;
+    uint64_t HOST_SECTOR_SIZE;
+    uint64_t SECTOR_PACK_TIME;
+
+    bool DFTL;
+    uint64_t MAP_CACHE_ENTRIES;
+    uint64_t MAP_ENTRY_SIZE;
+
+    bool LOG_BLOCK_FTL;
+    std::string LOG_BLOCK_SCHEME;
+    uint64_t LOG_BLOCKS;
     
     bool LOGGING;
     std::string LOG_DIR;
     bool WEAR_LEVEL_LOG;
+    bool WEAR_LEVEL_EXACT;
+    uint64_t WEAR_SKETCH_WIDTH;
+    uint64_t WEAR_SKETCH_DEPTH;
+    uint64_t WEAR_TOP_K;
     bool RUNTIME_WRITE; 
     bool PER_PACKAGE;
     bool QUEUE_EVENT_LOG;
     bool PLANE_STATE_LOG;
     bool WRITE_ARRIVE_LOG;
     bool READ_ARRIVE_LOG;
+    bool BINARY_EVENT_LOG;
+    uint64_t EVENT_LOG_BUFFER_SIZE;
+    std::string STATS_FORMAT;
 
     bool ENABLE_NV_SAVE;
     std::string NV_SAVE_FILE;
@@ -108,6 +161,8 @@ namespace NVDSim
     uint64_t READ_TIME;
     uint64_t WRITE_TIME;
     uint64_t ERASE_TIME;
+    uint64_t SUSPEND_TIME;
+    uint64_t RESUME_TIME;
     uint64_t COMMAND_LENGTH;
     uint64_t LOOKUP_TIME;
     uint64_t BUFFER_LOOKUP_TIME;
@@ -120,6 +175,8 @@ namespace NVDSim
     uint64_t CTRL_READ_QUEUE_LENGTH;
     uint64_t FTL_WRITE_QUEUE_LENGTH;
     uint64_t CTRL_WRITE_QUEUE_LENGTH;
+    uint64_t FTL_SLOTS;
+    uint64_t FTL_SHARDS;
 
     double READ_I;
     double WRITE_I;
@@ -152,6 +209,21 @@ namespace NVDSim
 	DEFINE_BOOL_PARAM(CTRL_WRITE_ON_QUEUE_SIZE, DEV_PARAM),
 	DEFINE_UINT64_PARAM(CTRL_WRITE_QUEUE_LIMIT, DEV_PARAM),
 	DEFINE_BOOL_PARAM(CTRL_IDLE_WRITE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(CTRL_OUT_OF_ORDER, DEV_PARAM),
+	DEFINE_UINT64_PARAM(CTRL_OOO_WINDOW, DEV_PARAM),
+	DEFINE_UINT64_PARAM(CTRL_OOO_AGE_CAP, DEV_PARAM),
+	DEFINE_BOOL_PARAM(DEADLINE_SCHEDULE, DEV_PARAM),
+	DEFINE_STRING_PARAM(TENANT_WEIGHTS, DEV_PARAM),
+	DEFINE_UINT64_PARAM(TENANT_QUEUE_LENGTH, DEV_PARAM),
+	DEFINE_BOOL_PARAM(ADAPTIVE_WRITE_DRAIN, DEV_PARAM),
+	DEFINE_FLOAT_PARAM(DRAIN_HIGH_WATERMARK, DEV_PARAM),
+	DEFINE_FLOAT_PARAM(DRAIN_LOW_WATERMARK, DEV_PARAM),
+	DEFINE_UINT64_PARAM(DRAIN_WINDOW, DEV_PARAM),
+	DEFINE_BOOL_PARAM(MULTI_PLANE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(CACHE_MODE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(ERASE_SUSPEND, DEV_PARAM),
+	DEFINE_BOOL_PARAM(PROGRAM_SUSPEND, DEV_PARAM),
+	DEFINE_UINT64_PARAM(MAX_SUSPENDS, DEV_PARAM),
 	DEFINE_BOOL_PARAM(PERFECT_SCHEDULE, DEV_PARAM),
 	DEFINE_BOOL_PARAM(ENABLE_WRITE_SCRIPT, DEV_PARAM),
 	DEFINE_STRING_PARAM(NV_WRITE_SCRIPT, DEV_PARAM),
@@ -165,16 +237,50 @@ namespace NVDSim
 	DEFINE_BOOL_PARAM(CUT_THROUGH, DEV_PARAM),
 	DEFINE_UINT64_PARAM(IN_BUFFER_SIZE, DEV_PARAM),
 	DEFINE_UINT64_PARAM(OUT_BUFFER_SIZE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(READ_CACHE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(READ_CACHE_SIZE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(READ_CACHE_LINE_SIZE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(READ_CACHE_WAYS, DEV_PARAM),
+	DEFINE_STRING_PARAM(READ_CACHE_POLICY, DEV_PARAM),
+	DEFINE_UINT64_PARAM(READ_CACHE_HIT_LATENCY, DEV_PARAM),
+	DEFINE_BOOL_PARAM(WRITE_BUFFER, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WRITE_BUFFER_PAGES, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WRITE_BUFFER_LINE_SIZE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WRITE_BUFFER_MAX_AGE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WRITE_BUFFER_LATENCY, DEV_PARAM),
+	DEFINE_BOOL_PARAM(PREFETCH, DEV_PARAM),
+	DEFINE_UINT64_PARAM(PREFETCH_STREAMS, DEV_PARAM),
+	DEFINE_UINT64_PARAM(PREFETCH_TRIGGER, DEV_PARAM),
+	DEFINE_UINT64_PARAM(PREFETCH_DEPTH, DEV_PARAM),
+	DEFINE_FLOAT_PARAM(PREFETCH_QUEUE_OCCUPANCY, DEV_PARAM),
 	DEFINE_BOOL_PARAM(CRIT_LINE_FIRST, DEV_PARAM),
+	DEFINE_BOOL_PARAM(PARTIAL_READS, DEV_PARAM),
+	DEFINE_UINT64_PARAM(SECTOR_SIZE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(SECTOR_MAPPING, DEV_PARAM),
+	DEFINE_UINT64_PARAM(HOST_SECTOR_SIZE, DEV_PARAM),
+	DEFINE_UINT64_PARAM(SECTOR_PACK_TIME, DEV_PARAM),
+	DEFINE_BOOL_PARAM(DFTL, DEV_PARAM),
+	DEFINE_UINT64_PARAM(MAP_CACHE_ENTRIES, DEV_PARAM),
+	DEFINE_UINT64_PARAM(MAP_ENTRY_SIZE, DEV_PARAM),
+	DEFINE_BOOL_PARAM(LOG_BLOCK_FTL, DEV_PARAM),
+	DEFINE_STRING_PARAM(LOG_BLOCK_SCHEME, DEV_PARAM),
+	DEFINE_UINT64_PARAM(LOG_BLOCKS, DEV_PARAM),
 	DEFINE_BOOL_PARAM(LOGGING, DEV_PARAM),
 	DEFINE_STRING_PARAM(LOG_DIR, DEV_PARAM),
 	DEFINE_BOOL_PARAM(WEAR_LEVEL_LOG, DEV_PARAM),
+	DEFINE_BOOL_PARAM(WEAR_LEVEL_EXACT, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WEAR_SKETCH_WIDTH, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WEAR_SKETCH_DEPTH, DEV_PARAM),
+	DEFINE_UINT64_PARAM(WEAR_TOP_K, DEV_PARAM),
 	DEFINE_BOOL_PARAM(RUNTIME_WRITE, DEV_PARAM),
 	DEFINE_BOOL_PARAM(PER_PACKAGE, DEV_PARAM),
 	DEFINE_BOOL_PARAM(QUEUE_EVENT_LOG, DEV_PARAM),
 	DEFINE_BOOL_PARAM(PLANE_STATE_LOG, DEV_PARAM),
 	DEFINE_BOOL_PARAM(WRITE_ARRIVE_LOG, DEV_PARAM),
 	DEFINE_BOOL_PARAM(READ_ARRIVE_LOG, DEV_PARAM),
+	DEFINE_BOOL_PARAM(BINARY_EVENT_LOG, DEV_PARAM),
+	DEFINE_UINT64_PARAM(EVENT_LOG_BUFFER_SIZE, DEV_PARAM),
+	DEFINE_STRING_PARAM(STATS_FORMAT, DEV_PARAM),
 	DEFINE_BOOL_PARAM(ENABLE_NV_SAVE, DEV_PARAM),
 	DEFINE_STRING_PARAM(NV_SAVE_FILE, DEV_PARAM),
 	DEFINE_BOOL_PARAM(ENABLE_NV_RESTORE, DEV_PARAM),
@@ -201,6 +307,8 @@ namespace NVDSim
 	DEFINE_UINT64_PARAM(READ_TIME,DEV_PARAM),
 	DEFINE_UINT64_PARAM(WRITE_TIME,DEV_PARAM),
 	DEFINE_UINT64_PARAM(ERASE_TIME,DEV_PARAM),
+	DEFINE_UINT64_PARAM(SUSPEND_TIME,DEV_PARAM),
+	DEFINE_UINT64_PARAM(RESUME_TIME,DEV_PARAM),
 	DEFINE_UINT64_PARAM(COMMAND_LENGTH,DEV_PARAM),
 	DEFINE_UINT64_PARAM(LOOKUP_TIME,DEV_PARAM),
 	DEFINE_UINT64_PARAM(BUFFER_LOOKUP_TIME,DEV_PARAM),
@@ -212,6 +320,8 @@ namespace NVDSim
 	DEFINE_UINT64_PARAM(CTRL_READ_QUEUE_LENGTH,DEV_PARAM),
 	DEFINE_UINT64_PARAM(FTL_WRITE_QUEUE_LENGTH,DEV_PARAM),
 	DEFINE_UINT64_PARAM(CTRL_WRITE_QUEUE_LENGTH,DEV_PARAM),
+	DEFINE_UINT64_PARAM(FTL_SLOTS,DEV_PARAM),
+	DEFINE_UINT64_PARAM(FTL_SHARDS,DEV_PARAM),
 	DEFINE_DOUBLE_PARAM(READ_I,DEV_PARAM),
 	DEFINE_DOUBLE_PARAM(WRITE_I,DEV_PARAM),
 	DEFINE_DOUBLE_PARAM(ERASE_I,DEV_PARAM),
@@ -232,6 +342,57 @@ namespace NVDSim
 	{"", NULL, UINT64, SYS_PARAM, false} // tracer value to signify end of list; if you delete it, epic fail will result
     };
 
+    // Optional parameters and the values they take if they are missing from the ini file
+    // this way adding a new option doesn't break every ini file that already exists
+    static DefaultValue defaultValues[] = {
+	{"EVENT_LOG_BUFFER_SIZE", "4194304"},
+	{"WEAR_SKETCH_WIDTH", "4096"},
+	{"WEAR_SKETCH_DEPTH", "4"},
+	{"WEAR_TOP_K", "32"},
+	{"CTRL_OOO_WINDOW", "8"},
+	{"CTRL_OOO_AGE_CAP", "100000"},
+	{"MAX_SUSPENDS", "2"},
+	{"SUSPEND_TIME", "20000"},
+	{"RESUME_TIME", "10000"},
+	{"FTL_SLOTS", "1"},
+	{"FTL_SHARDS", "1"},
+	{"DEADLINE_SCHEDULE", "0"},
+	{"TENANT_WEIGHTS", "1"},
+	{"TENANT_QUEUE_LENGTH", "16"},
+	{"ADAPTIVE_WRITE_DRAIN", "0"},
+	{"DRAIN_HIGH_WATERMARK", "0.9"},
+	{"DRAIN_LOW_WATERMARK", "0.25"},
+	{"DRAIN_WINDOW", "10000"},
+	{"READ_CACHE", "0"},
+	{"READ_CACHE_SIZE", "16777216"},
+	{"READ_CACHE_LINE_SIZE", "4096"},
+	{"READ_CACHE_WAYS", "8"},
+	{"READ_CACHE_POLICY", "LRU"},
+	{"READ_CACHE_HIT_LATENCY", "20"},
+	{"WRITE_BUFFER", "0"},
+	{"WRITE_BUFFER_PAGES", "64"},
+	{"WRITE_BUFFER_LINE_SIZE", "64"},
+	{"WRITE_BUFFER_MAX_AGE", "100000"},
+	{"WRITE_BUFFER_LATENCY", "20"},
+	{"PREFETCH", "0"},
+	{"PREFETCH_STREAMS", "8"},
+	{"PREFETCH_TRIGGER", "2"},
+	{"PREFETCH_DEPTH", "4"},
+	{"PREFETCH_QUEUE_OCCUPANCY", "0.5"},
+	{"PARTIAL_READS", "0"},
+	{"SECTOR_SIZE", "512"},
+	{"SECTOR_MAPPING", "0"},
+	{"HOST_SECTOR_SIZE", "4096"},
+	{"SECTOR_PACK_TIME", "10000"},
+	{"DFTL", "0"},
+	{"MAP_CACHE_ENTRIES", "4096"},
+	{"MAP_ENTRY_SIZE", "8"},
+	{"LOG_BLOCK_FTL", "0"},
+	{"LOG_BLOCK_SCHEME", "FAST"},
+	{"LOG_BLOCKS", "8"},
+	{"", ""} // tracer value to signify end of list
+    };
+
     void Init::WriteValuesOut(std::ofstream &visDataOut) 
     {
 	//DEBUG("WRITE CALLED");
@@ -463,6 +624,10 @@ namespace NVDSim
 	{
 	    if (!configMap[i].wasSet) 
 	    {
+		if (Init::SetDefault(configMap[i].iniKey))
+		{
+		    continue;
+		}
 		DEBUG("WARNING: KEY "<<configMap[i].iniKey<<" NOT FOUND IN INI FILE.");
 		switch (configMap[i].variableType) 
 		{
@@ -509,6 +674,23 @@ namespace NVDSim
 	}
 	return true;
     }
+
+    bool Init::SetDefault(string key)
+    {
+	for (size_t i=0; defaultValues[i].iniKey.size() != 0; i++)
+	{
+	    if (key.compare(defaultValues[i].iniKey) == 0)
+	    {
+		if (DEBUG_INIT)
+		{
+		    DEBUG("\tSetting Default: "<<key<<"="<<defaultValues[i].value);
+		}
+		Init::SetKey(key, defaultValues[i].value);
+		return true;
+	    }
+	}
+	return false;
+    }
     /*unecessary right now
       void Init::InitEnumsFromStrings() {
       if (ADDRESS_MAPPING_SCHEME == "scheme1") {
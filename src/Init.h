@@ -65,6 +65,13 @@ namespace NVDSim
 		bool wasSet; 
 	} ConfigMap;
 
+	// default values for the optional parameters that older ini files won't have
+	typedef struct _defaultValue
+	{
+		string iniKey;
+		string value;
+	} DefaultValue;
+
 	class Init 
 	{		
 		public:
@@ -76,6 +83,7 @@ namespace NVDSim
 			static void WriteValuesOut(std::ofstream &visDataOut);
 		private:
 			static void Trim(string &str);
+			static bool SetDefault(string key);
 	};
 }
 
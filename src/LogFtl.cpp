@@ -0,0 +1,555 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//LogFtl.cpp
+//class file for the hybrid log block ftl
+//
+#include "LogFtl.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+LogFtl::LogFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s) 
+    : GCFtl(c, l, p, s)
+{
+	uint64_t b, i;
+	uint64_t planes = NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE;
+
+	fast = (LOG_BLOCK_SCHEME.compare("FAST") == 0);
+
+	// hand blocks out across the planes so that neighbouring logical blocks don't all land on one
+	for (b = 0; b < BLOCKS_PER_PLANE; b++)
+	{
+		for (i = 0; i < planes; i++)
+		{
+			free_blocks.push_back(i * BLOCKS_PER_PLANE + b);
+		}
+	}
+
+	merge_kind = SWITCH_MERGE;
+	merge_start = 0;
+	merge_copies = 0;
+	merge_erases = 0;
+}
+
+bool LogFtl::addTransaction(FlashTransaction &t){
+    // everything is kept by the page, half a page can't be written in place
+    if((t.transactionType == DATA_WRITE || t.transactionType == DATA_READ) && t.address < (VIRTUAL_TOTAL_SIZE*1024) && t.address % NV_PAGE_SIZE != 0)
+    {
+	ERROR("The log block ftl only takes page aligned addresses");
+	exit(-1);
+    }
+    return GCFtl::addTransaction(t);
+}
+
+void LogFtl::update(void){
+	// there is no page level gc here, the only thing that ever gets erased is what a merge gives back
+	if (gc_status)
+	{
+		continueMerge();
+	}
+
+	updateSlots();
+
+	//place power callbacks to hybrid_system
+#if Verbose_Power_Callback
+	  controller->returnPowerData(idle_energy, access_energy, erase_energy);
+#endif
+}
+
+void LogFtl::updateSlot(void){
+	// a write the log blocks can't take right now has to wait for a merge
+	if (busy && lookupCounter <= 0 && !write_queues_full && currentTransaction.transactionType == DATA_WRITE)
+	{
+		uint64_t pAddr;
+		list<LogBlock>::iterator victim = logs.end();
+		if (!placeWrite(currentTransaction.address, pAddr, victim))
+		{
+			if (!gc_status && victim != logs.end())
+			{
+				startMerge(victim);
+			}
+			// let go of it so the slot can do the merge, it is still in its queue
+			busy = 0;
+			return;
+		}
+	}
+
+	GCFtl::updateSlot();
+}
+
+bool LogFtl::findFreePage(uint64_t start, uint64_t &block, uint64_t &page)
+{
+    uint64_t pAddr;
+    if (currentTransaction.transactionType == GC_DATA_WRITE)
+    {
+	// the merge already decided where this goes
+	pAddr = gc_moves[currentTransaction.address];
+    }
+    else
+    {
+	list<LogBlock>::iterator victim;
+	if (!placeWrite(currentTransaction.address, pAddr, victim))
+	{
+	    return false;
+	}
+    }
+    block = pAddr / BLOCK_SIZE;
+    page = (pAddr / NV_PAGE_SIZE) % PAGES_PER_BLOCK;
+    return true;
+}
+
+void LogFtl::write_used_handler(uint64_t vAddr)
+{
+    // the old page is invalidated in write_success once the new one has a home
+}
+
+void LogFtl::write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped)
+{
+    list<LogBlock>::iterator it;
+
+    used[block][page] = true;
+    used_page_count++;
+
+    // the gc ftl would pop the wrong queue for a gc write here so say which one it is
+    popFront(gc ? GC_WRITE : WRITE);
+    busy = 0;
+    write_counter++;
+
+    if (LOGGING && !gc)
+    {
+	if (mapped)
+	    log->write_mapped();
+	else
+	    log->write_unmapped();
+    }
+
+    if (gc)
+    {
+	gc_moves.erase(vAddr);
+    }
+
+    if (mapped)
+    {
+	// the old copy may already have been erased out from under us by a merge
+	unordered_map<uint64_t, uint64_t>::iterator old = reverseMap.find(addressMap[vAddr]);
+	if (old != reverseMap.end())
+	{
+	    dirty[old->first / BLOCK_SIZE][(old->first / NV_PAGE_SIZE) % PAGES_PER_BLOCK] = true;
+	    dirty_page_count++;
+	    reverseMap.erase(old);
+	}
+    }
+    addressMap[vAddr] = pAddr;
+    reverseMap[pAddr] = vAddr;
+
+    for (it = logs.begin(); it != logs.end(); it++)
+    {
+	if ((*it).block == block)
+	{
+	    (*it).next_page = page + 1;
+	    break;
+	}
+    }
+}
+
+bool LogFtl::hasGarbage(void)
+{
+    // dirty pages only come back through merges, never through the gc
+    return false;
+}
+
+void LogFtl::GCReadDone(uint64_t vAddr)
+{
+    uint64_t erase_block;
+    // a merge can have the same page holding up the erase of both the log block and the data block
+    while (gcReadFinished(vAddr, erase_block))
+    {
+	queueErase(erase_block);
+    }
+
+    FlashTransaction trans = FlashTransaction(GC_DATA_WRITE, vAddr, NULL);
+    addGcTransaction(trans);
+}
+
+void LogFtl::blockErased(uint64_t block)
+{
+    for (uint64_t i = 0; i < PAGES_PER_BLOCK; i++)
+    {
+	reverseMap.erase(block * BLOCK_SIZE + i * NV_PAGE_SIZE);
+    }
+    free_blocks.push_back(block);
+}
+
+uint64_t LogFtl::pageAddress(uint64_t lbn, uint64_t offset)
+{
+    return (lbn * PAGES_PER_BLOCK + offset) * NV_PAGE_SIZE;
+}
+
+// finds where a host write can go without waiting on anything
+// returns false if it has to wait, victim is the log block to merge to make room if there is one
+bool LogFtl::placeWrite(uint64_t vAddr, uint64_t &pAddr, list<LogBlock>::iterator &victim)
+{
+    uint64_t lbn = (vAddr / NV_PAGE_SIZE) / PAGES_PER_BLOCK;
+    uint64_t offset = (vAddr / NV_PAGE_SIZE) % PAGES_PER_BLOCK;
+    list<LogBlock>::iterator it, log = logs.end();
+
+    victim = logs.end();
+
+    // a merge is moving this block around
+    if (merging.find(lbn) != merging.end())
+    {
+	return false;
+    }
+
+    // first time this logical block is written, it gets a data block of its own
+    unordered_map<uint64_t, uint64_t>::iterator data = data_blocks.find(lbn);
+    if (data == data_blocks.end())
+    {
+	// always keep one back for a full merge to copy into
+	if (free_blocks.size() > 1)
+	{
+	    data_blocks[lbn] = free_blocks.front();
+	    free_blocks.pop_front();
+	    pAddr = data_blocks[lbn] * BLOCK_SIZE + offset * NV_PAGE_SIZE;
+	    return true;
+	}
+	victim = oldestLog();
+	return false;
+    }
+
+    // the page hasn't been written since the data block was, so write it in place
+    if (!used[data->second][offset])
+    {
+	pAddr = data->second * BLOCK_SIZE + offset * NV_PAGE_SIZE;
+	return true;
+    }
+
+    for (it = logs.begin(); it != logs.end(); it++)
+    {
+	if (!(*it).shared)
+	{
+	    if (!fast && (*it).lbn == lbn)
+	    {
+		log = it;
+	    }
+	    // FAST only has the one sequential log block
+	    else if (fast)
+	    {
+		log = it;
+	    }
+	}
+    }
+
+    if (!fast)
+    {
+	// BAST, each logical block gets a log block of its own until that fills up
+	if (log != logs.end())
+	{
+	    if ((*log).next_page < PAGES_PER_BLOCK)
+	    {
+		pAddr = (*log).block * BLOCK_SIZE + (*log).next_page * NV_PAGE_SIZE;
+		return true;
+	    }
+	    victim = log;
+	    return false;
+	}
+	if (newLog(false, lbn, log))
+	{
+	    pAddr = (*log).block * BLOCK_SIZE;
+	    return true;
+	}
+	victim = oldestLog();
+	return false;
+    }
+
+    // FAST, a rewrite starting at the first page of a block is probably the whole block going
+    // so it gets the sequential log block, everything else goes to the shared random ones
+    if (offset == 0)
+    {
+	if (log != logs.end())
+	{
+	    // already got it for this write but it didn't make it into the controller
+	    if ((*log).lbn == lbn && (*log).next_page == 0)
+	    {
+		pAddr = (*log).block * BLOCK_SIZE;
+		return true;
+	    }
+	    victim = log;
+	    return false;
+	}
+	if (newLog(false, lbn, log))
+	{
+	    pAddr = (*log).block * BLOCK_SIZE;
+	    return true;
+	}
+	victim = oldestLog();
+	return false;
+    }
+    if (log != logs.end() && (*log).lbn == lbn && (*log).next_page == offset)
+    {
+	pAddr = (*log).block * BLOCK_SIZE + offset * NV_PAGE_SIZE;
+	return true;
+    }
+
+    // the newest random log block is the one being filled
+    for (it = logs.begin(), log = logs.end(); it != logs.end(); it++)
+    {
+	if ((*it).shared)
+	{
+	    log = it;
+	}
+    }
+    if (log != logs.end() && (*log).next_page < PAGES_PER_BLOCK)
+    {
+	pAddr = (*log).block * BLOCK_SIZE + (*log).next_page * NV_PAGE_SIZE;
+	return true;
+    }
+    if (newLog(true, 0, log))
+    {
+	pAddr = (*log).block * BLOCK_SIZE;
+	return true;
+    }
+    victim = oldestLog();
+    return false;
+}
+
+// starts a new log block if we're allowed another one
+bool LogFtl::newLog(bool shared, uint64_t lbn, list<LogBlock>::iterator &log)
+{
+    if (logs.size() >= LOG_BLOCKS || free_blocks.size() <= 1)
+    {
+	return false;
+    }
+
+    LogBlock temp;
+    temp.block = free_blocks.front();
+    temp.next_page = 0;
+    temp.shared = shared;
+    temp.lbn = lbn;
+    free_blocks.pop_front();
+
+    logs.push_back(temp);
+    log = logs.end();
+    log--;
+    return true;
+}
+
+// the log block to merge when we need another one, FAST would rather keep its sequential block
+list<LogFtl::LogBlock>::iterator LogFtl::oldestLog(void)
+{
+    list<LogBlock>::iterator it;
+    if (logs.empty())
+    {
+	ERROR("FLASH DIMM IS COMPLETELY FULL AND DEADLOCKED - there are no log blocks left to merge.");
+	exit(9001);
+    }
+    for (it = logs.begin(); fast && it != logs.end(); it++)
+    {
+	if ((*it).shared)
+	{
+	    return it;
+	}
+    }
+    return logs.begin();
+}
+
+void LogFtl::startMerge(list<LogBlock>::iterator victim)
+{
+    LogBlock merged = *victim;
+    list<uint64_t> valid;
+    list<uint64_t>::iterator it;
+    uint64_t page, vAddr, lbn;
+    unordered_map<uint64_t, uint64_t>::iterator found;
+    bool in_order = !merged.shared && merged.next_page > 0;
+
+    logs.erase(victim);
+
+    start_erase = erase_count;
+    gc_status = 1;
+    merge_start = currentClockCycle;
+    merge_copies = 0;
+    merge_erases = 0;
+
+    // whatever is still valid in the log block
+    for (page = 0; page < merged.next_page; page++)
+    {
+	found = reverseMap.find(merged.block * BLOCK_SIZE + page * NV_PAGE_SIZE);
+	if (found == reverseMap.end())
+	{
+	    in_order = false;
+	    continue;
+	}
+	vAddr = found->second;
+	valid.push_front(vAddr);
+	if (vAddr != pageAddress(merged.lbn, page))
+	{
+	    in_order = false;
+	}
+    }
+
+    if (in_order)
+    {
+	// the log block already holds the start of the logical block in place so it just takes over from the data block
+	list<uint64_t> reads;
+	lbn = merged.lbn;
+	merging.insert(lbn);
+
+	if (merged.next_page == PAGES_PER_BLOCK)
+	{
+	    merge_kind = SWITCH_MERGE;
+	}
+	else
+	{
+	    // the rest of it gets copied in behind
+	    merge_kind = PARTIAL_MERGE;
+	    for (page = merged.next_page; page < PAGES_PER_BLOCK; page++)
+	    {
+		vAddr = pageAddress(lbn, page);
+		if (addressMap.find(vAddr) != addressMap.end())
+		{
+		    copyPage(vAddr, merged.block * BLOCK_SIZE + page * NV_PAGE_SIZE);
+		    reads.push_front(vAddr);
+		}
+	    }
+	}
+
+	found = data_blocks.find(lbn);
+	if (found != data_blocks.end())
+	{
+	    eraseAfter(found->second, reads);
+	}
+	data_blocks[lbn] = merged.block;
+    }
+    else
+    {
+	// every logical block with anything in the log block gets copied out whole
+	merge_kind = FULL_MERGE;
+	for (it = valid.begin(); it != valid.end(); it++)
+	{
+	    lbn = ((*it) / NV_PAGE_SIZE) / PAGES_PER_BLOCK;
+	    if (merging.find(lbn) == merging.end())
+	    {
+		merging.insert(lbn);
+		merge_steps.push_back(lbn);
+	    }
+	}
+	// the log block itself can go once everything in it has been read out
+	eraseAfter(merged.block, valid);
+    }
+
+    continueMerge();
+}
+
+void LogFtl::continueMerge(void)
+{
+    uint64_t lbn, block, page, vAddr;
+    unordered_map<uint64_t, uint64_t>::iterator data;
+
+    // a full merge copies one logical block at a time as blocks come free to copy into
+    while (!merge_steps.empty() && !free_blocks.empty())
+    {
+	list<uint64_t> reads;
+	lbn = merge_steps.front();
+	merge_steps.pop_front();
+	block = free_blocks.front();
+	free_blocks.pop_front();
+
+	for (page = 0; page < PAGES_PER_BLOCK; page++)
+	{
+	    vAddr = pageAddress(lbn, page);
+	    if (addressMap.find(vAddr) != addressMap.end())
+	    {
+		copyPage(vAddr, block * BLOCK_SIZE + page * NV_PAGE_SIZE);
+		reads.push_front(vAddr);
+	    }
+	}
+
+	data = data_blocks.find(lbn);
+	if (data != data_blocks.end())
+	{
+	    eraseAfter(data->second, reads);
+	}
+	data_blocks[lbn] = block;
+    }
+
+    if (!merge_steps.empty() && free_blocks.empty() && gc_pending_erase.empty() && gcQueue.empty())
+    {
+	ERROR("FLASH DIMM IS COMPLETELY FULL AND DEADLOCKED - a merge has nowhere to copy to.");
+	exit(9001);
+    }
+
+    if (merge_steps.empty() && gc_pending_erase.empty() && gcQueue.empty() && erase_count == start_erase + merge_erases)
+    {
+	if (LOGGING)
+	{
+	    log->log_block_merge(merge_kind, merge_copies, currentClockCycle - merge_start);
+	}
+	merging.clear();
+	gc_status = 0;
+    }
+}
+
+void LogFtl::copyPage(uint64_t vAddr, uint64_t pAddr)
+{
+    gc_moves[vAddr] = pAddr;
+    merge_copies++;
+
+    FlashTransaction trans = FlashTransaction(GC_DATA_READ, vAddr, NULL);
+    addGcTransaction(trans);
+}
+
+// erases the block once all of the reads it is waiting on have finished
+void LogFtl::eraseAfter(uint64_t block, list<uint64_t> &reads)
+{
+    if (reads.empty())
+    {
+	queueErase(block);
+    }
+    else
+    {
+	PendingErase temp_erase;
+	temp_erase.erase_block = block;
+	temp_erase.pending_reads = reads;
+	gc_pending_erase.push_back(temp_erase);
+    }
+}
+
+void LogFtl::queueErase(uint64_t block)
+{
+    merge_erases++;
+
+    FlashTransaction trans = FlashTransaction(BLOCK_ERASE, block * BLOCK_SIZE, NULL);
+    addGcTransaction(trans);
+}
@@ -0,0 +1,113 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVLOGFTL_H
+#define NVLOGFTL_H
+//LogFtl.h
+//header file for the hybrid log block ftl, see LOG_BLOCK_FTL
+//
+//Data is mapped by block, page n of a logical block always sits on page n of
+//its data block, so the controller only needs one entry per block. A write to
+//a page of the data block that is still free goes right there. Anything else
+//goes to one of LOG_BLOCKS page mapped log blocks. With BAST each log block
+//takes the updates of just one data block, with FAST they are shared and one
+//more is kept for a data block being rewritten from its first page on.
+//
+//Taking a log block back is a merge and goes through the gc like any other
+//gc work. A log block holding all of its data block in order just becomes
+//the new data block (switch merge), one holding the start of it in order gets
+//the rest copied in behind (partial merge), anything else has every
+//logical block it holds copied out to a fresh block (full merge).
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "GCFtl.h"
+
+namespace NVDSim{
+        class NVDIMM;
+	class LogFtl : public GCFtl{
+		public:
+	                LogFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s);
+			bool addTransaction(FlashTransaction &t);
+			void update(void);
+			void updateSlot(void);
+			bool findFreePage(uint64_t start, uint64_t &block, uint64_t &page);
+			void write_used_handler(uint64_t vAddr);
+			void write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped);
+			bool hasGarbage(void);
+
+			void GCReadDone(uint64_t vAddr);
+
+		protected:
+			void blockErased(uint64_t block);
+
+		private:
+			class LogBlock
+			{
+			public:
+			    uint64_t block;
+			    uint64_t next_page; // pages are written in order
+			    bool shared; // a FAST random log block, otherwise it belongs to lbn
+			    uint64_t lbn;
+			};
+
+			bool placeWrite(uint64_t vAddr, uint64_t &pAddr, std::list<LogBlock>::iterator &victim);
+			bool newLog(bool shared, uint64_t lbn, std::list<LogBlock>::iterator &log);
+			std::list<LogBlock>::iterator oldestLog(void);
+			void startMerge(std::list<LogBlock>::iterator victim);
+			void continueMerge(void);
+			void copyPage(uint64_t vAddr, uint64_t pAddr);
+			void eraseAfter(uint64_t block, std::list<uint64_t> &reads);
+			void queueErase(uint64_t block);
+			uint64_t pageAddress(uint64_t lbn, uint64_t offset);
+
+			bool fast; // LOG_BLOCK_SCHEME
+
+			std::unordered_map<uint64_t, uint64_t> data_blocks; // logical block to the block holding it
+			std::list<LogBlock> logs; // oldest first
+			std::list<uint64_t> free_blocks; // erased and not given out yet
+			std::unordered_map<uint64_t, uint64_t> reverseMap; // physical page to the page it holds, only while it is valid
+
+			// the merge that is running, there is only ever one
+			LogBlockMerge merge_kind;
+			uint64_t merge_start;
+			uint64_t merge_copies;
+			uint64_t merge_erases; // erases it has sent so far
+			std::list<uint64_t> merge_steps; // logical blocks a full merge still needs a fresh block for
+			std::unordered_set<uint64_t> merging; // logical blocks the host has to keep out of until it's done
+			std::unordered_map<uint64_t, uint64_t> gc_moves; // pages being copied to where they go
+	};
+}
+#endif
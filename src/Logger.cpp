@@ -46,6 +46,44 @@ Logger::Logger()
 
 	// NOTE: Temporary debuging stuff **********************
 	num_locks = 0;
+
+	num_multi_plane = 0;
+	multi_plane_planes = 0;
+	num_suspends = 0;
+	num_deadlines = 0;
+	num_deadline_misses = 0;
+	num_write_drains = 0;
+	num_read_cache_hits = 0;
+	num_read_cache_misses = 0;
+	num_read_cache_evictions = 0;
+	num_buffered_writes = 0;
+	num_buffer_merges = 0;
+	num_buffer_rewrites = 0;
+	num_buffer_forwards = 0;
+	num_buffer_fills = 0;
+	num_buffer_flushes = vector<uint64_t>(3, 0);
+	num_prefetches = 0;
+	num_prefetches_used = 0;
+	num_prefetches_late = 0;
+	num_read_transfers = 0;
+	read_transfer_bytes = 0;
+	num_sector_writes = 0;
+	num_sector_merges = 0;
+	num_sector_programs = 0;
+	num_sectors_packed = 0;
+	num_gc_sector_programs = 0;
+	num_gc_sectors_moved = 0;
+	num_map_hits = 0;
+	num_map_misses = 0;
+	num_map_reads = 0;
+	map_read_cycles = 0;
+	num_map_writes = 0;
+	num_merges = vector<uint64_t>(3, 0);
+	merge_copies = 0;
+	merge_cycles = 0;
+	drain_high_watermark = 0.0;
+	drain_low_watermark = 0.0;
+	drain_pressure = 0.0;
 	time_locked = 0;
 	lock_start = 0;
 	//******************************************************
@@ -101,8 +139,141 @@ Logger::Logger()
 	    }
 	}
 
+	wear = NULL;
+	if(WEAR_LEVEL_LOG)
+	{
+	    wear = new WearTracker(WEAR_SKETCH_WIDTH, WEAR_SKETCH_DEPTH, WEAR_TOP_K, TOTAL_SIZE / BLOCK_SIZE);
+	}
+
+	event_log = NULL;
+	if(BINARY_EVENT_LOG && (QUEUE_EVENT_LOG || PLANE_STATE_LOG))
+	{
+	    string command_str = "test -e "+LOG_DIR+" || mkdir "+LOG_DIR;
+	    const char * command = command_str.c_str();
+	    int sys_done = system(command);
+	    if (sys_done != 0)
+	    {
+		WARNING("Something might have gone wrong when nvdimm attempted to makes its log directory");
+	    }
+	    event_log = new EventLog(LOG_DIR+"Events.bin", EVENT_LOG_BUFFER_SIZE);
+	}
+
 	idle_energy = vector<double>(NUM_PACKAGES, 0.0); 
 	access_energy = vector<double>(NUM_PACKAGES, 0.0);        
+
+	stats.counter("accesses", &num_accesses);
+	stats.counter("reads", &num_reads);
+	stats.counter("writes", &num_writes);
+	stats.counter("idle_writes", &num_idle_writes);
+	stats.counter("forced_writes", &num_forced);
+	stats.counter("locks", &num_locks);
+	stats.counter("cycles_locked", &time_locked);
+	stats.counter("unmapped", &num_unmapped);
+	stats.counter("mapped", &num_mapped);
+	stats.counter("read_unmapped", &num_read_unmapped);
+	stats.counter("read_mapped", &num_read_mapped);
+	stats.counter("write_unmapped", &num_write_unmapped);
+	stats.counter("write_mapped", &num_write_mapped);
+	stats.derived("average_read_latency", [this]() { return divide((double)average_read_latency, (double)num_reads); });
+	stats.derived("average_write_latency", [this]() { return divide((double)average_write_latency, (double)num_writes); });
+	stats.derived("average_queue_latency", [this]() { return divide((double)average_queue_latency, (double)num_accesses); });
+	stats.counter("max_ftl_queue_length", &max_ftl_queue_length);
+	stats.counter("multi_plane_ops", &num_multi_plane);
+	stats.counter("multi_plane_planes", &multi_plane_planes);
+	stats.counter("suspends", &num_suspends);
+	stats.counter("deadlines", &num_deadlines);
+	stats.counter("deadline_misses", &num_deadline_misses);
+	stats.derived("deadline_miss_rate", [this]() { return divide((double)num_deadline_misses, (double)num_deadlines); });
+	stats.histogram("deadline_lateness", &deadline_lateness_hist);
+	if(ADAPTIVE_WRITE_DRAIN)
+	{
+	    stats.counter("write_drains", &num_write_drains);
+	    stats.value("write_drain_high_watermark", &drain_high_watermark);
+	    stats.value("write_drain_low_watermark", &drain_low_watermark);
+	    stats.value("write_drain_pressure", &drain_pressure);
+	}
+	if(READ_CACHE)
+	{
+	    stats.counter("read_cache_hits", &num_read_cache_hits);
+	    stats.counter("read_cache_misses", &num_read_cache_misses);
+	    stats.derived("read_cache_hit_rate", [this]() { return divide((double)num_read_cache_hits, (double)(num_read_cache_hits + num_read_cache_misses)); });
+	    stats.counter("read_cache_evictions", &num_read_cache_evictions);
+	}
+	if(WRITE_BUFFER)
+	{
+	    stats.counter("write_buffer_writes", &num_buffered_writes);
+	    stats.counter("write_buffer_merges", &num_buffer_merges);
+	    stats.counter("write_buffer_rewrites", &num_buffer_rewrites);
+	    stats.counter("write_buffer_forwards", &num_buffer_forwards);
+	    stats.counter("write_buffer_fills", &num_buffer_fills);
+	    stats.counter("write_buffer_full_flushes", &num_buffer_flushes[FULL_PAGE_FLUSH]);
+	    stats.counter("write_buffer_aged_flushes", &num_buffer_flushes[AGED_FLUSH]);
+	    stats.counter("write_buffer_eviction_flushes", &num_buffer_flushes[EVICTION_FLUSH]);
+	    // host writes per page actually programmed
+	    stats.derived("write_buffer_write_reduction", [this]() { return divide((double)num_buffered_writes, (double)(num_buffer_flushes[FULL_PAGE_FLUSH] + num_buffer_flushes[AGED_FLUSH] + num_buffer_flushes[EVICTION_FLUSH])); });
+	}
+	if(PREFETCH)
+	{
+	    stats.counter("prefetches", &num_prefetches);
+	    stats.counter("prefetches_used", &num_prefetches_used);
+	    stats.counter("prefetches_late", &num_prefetches_late);
+	    // how many of the prefetches were worth it and how many of the reads that would have gone to the flash they saved
+	    stats.derived("prefetch_accuracy", [this]() { return divide((double)num_prefetches_used, (double)num_prefetches); });
+	    stats.derived("prefetch_coverage", [this]() { return divide((double)num_prefetches_used, (double)(num_prefetches_used + num_read_cache_misses)); });
+	}
+	if(PARTIAL_READS)
+	{
+	    stats.counter("read_transfer_bytes", &read_transfer_bytes);
+	    // fraction of the bytes sensed that actually went over the buses
+	    stats.derived("read_transfer_fraction", [this]() { return divide((double)read_transfer_bytes, (double)(num_read_transfers * NV_PAGE_SIZE)); });
+	}
+	if(SECTOR_MAPPING)
+	{
+	    stats.counter("sector_writes", &num_sector_writes);
+	    stats.counter("sector_merges", &num_sector_merges);
+	    stats.counter("sector_programs", &num_sector_programs);
+	    stats.counter("gc_sector_programs", &num_gc_sector_programs);
+	    stats.counter("gc_sectors_moved", &num_gc_sectors_moved);
+	    // sectors of flash programmed for each sector the host wrote, partly packed pages count in full
+	    stats.derived("write_amplification", [this]() { return divide((double)((num_sector_programs + num_gc_sector_programs) * (NV_PAGE_SIZE / HOST_SECTOR_SIZE)), (double)num_sector_writes); });
+	    // how full the pages were when they were programmed
+	    stats.derived("sector_pack_fill", [this]() { return divide((double)(num_sectors_packed + num_gc_sectors_moved), (double)((num_sector_programs + num_gc_sector_programs) * (NV_PAGE_SIZE / HOST_SECTOR_SIZE))); });
+	}
+	if(DFTL)
+	{
+	    // what the cached part of the map costs in controller memory
+	    stats.derived("map_cache_bytes", []() { return (double)(MAP_CACHE_ENTRIES * MAP_ENTRY_SIZE); });
+	    stats.counter("map_cache_hits", &num_map_hits);
+	    stats.counter("map_cache_misses", &num_map_misses);
+	    stats.derived("map_cache_hit_rate", [this]() { return divide((double)num_map_hits, (double)(num_map_hits + num_map_misses)); });
+	    stats.counter("map_reads", &num_map_reads);
+	    stats.counter("map_writes", &num_map_writes);
+	    // in cycles, what a miss that had to go to the flash added to its request
+	    stats.derived("average_map_read_latency", [this]() { return divide((double)map_read_cycles, (double)num_map_reads); });
+	}
+	if(LOG_BLOCK_FTL)
+	{
+	    // controller memory for the block map plus the page maps of the log blocks, next to what a full page map would need
+	    stats.derived("map_bytes", []() { return (double)((VIRTUAL_TOTAL_SIZE / BLOCK_SIZE + LOG_BLOCKS * FTL_SHARDS * PAGES_PER_BLOCK) * MAP_ENTRY_SIZE); });
+	    stats.derived("page_map_bytes", []() { return (double)((VIRTUAL_TOTAL_SIZE / NV_PAGE_SIZE) * MAP_ENTRY_SIZE); });
+	    stats.counter("switch_merges", &num_merges[SWITCH_MERGE]);
+	    stats.counter("partial_merges", &num_merges[PARTIAL_MERGE]);
+	    stats.counter("full_merges", &num_merges[FULL_MERGE]);
+	    stats.counter("merge_page_copies", &merge_copies);
+	    // pages copied for each page the host wrote
+	    stats.derived("merge_copies_per_write", [this]() { return divide((double)merge_copies, (double)(num_write_mapped + num_write_unmapped)); });
+	    stats.derived("average_merge_latency", [this]() { return divide((double)merge_cycles, (double)(num_merges[SWITCH_MERGE] + num_merges[PARTIAL_MERGE] + num_merges[FULL_MERGE])); });
+	}
+	stats.histogram("read_latency", &read_latency_hist);
+	stats.histogram("write_latency", &write_latency_hist);
+	stats.histogram("queue_latency", &queue_latency_hist);
+	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
+	{
+	    stringstream prefix;
+	    prefix << "package" << i << ".";
+	    stats.derived(prefix.str()+"idle_energy_mj", [this, i]() { return idle_energy[i] * VCC * 0.000000001; });
+	    stats.derived(prefix.str()+"access_energy_mj", [this, i]() { return access_energy[i] * VCC * 0.000000001; });
+	}
 }
 
 void Logger::update()
@@ -262,14 +433,7 @@ void Logger::access_stop(uint64_t addr, uint64_t paddr)
 	    this->write_latency(a.stop - a.start);
 	    if(WEAR_LEVEL_LOG)
 	    {
-		if(writes_per_address.count(a.pAddr) == 0)
-		{
-		    writes_per_address[a.pAddr] = 1;
-		}
-		else
-		{
-		    writes_per_address[a.pAddr]++;
-		}
+		this->wear_write(a.pAddr);
 	    }
 	}
 	
@@ -286,6 +450,14 @@ void Logger::access_stop(uint64_t addr, uint64_t paddr)
 
 void Logger::log_ftl_queue_event(bool write, std::list<FlashTransaction> *queue)
 {
+    if(event_log != NULL)
+    {
+	uint64_t address = queue->empty() ? 0 : queue->front().address;
+	uint64_t op = queue->empty() ? EMPTY : queue->front().transactionType;
+	event_log->record(write ? FTL_WRITE_QUEUE_EVENT : FTL_READ_QUEUE_EVENT, currentClockCycle, address, 0, 0, 0, queue->size(), op);
+	return;
+    }
+
     if(!write)
     {
 	if(first_ftl_read_log == true)
@@ -340,6 +512,21 @@ void Logger::log_ftl_queue_event(bool write, std::list<FlashTransaction> *queue)
 
 void Logger::log_ctrl_queue_event(bool write, uint64_t number, std::list<ChannelPacket*> *queue)
 {
+    if(event_log != NULL)
+    {
+	if(queue->empty())
+	{
+	    event_log->record(write ? CTRL_WRITE_QUEUE_EVENT : CTRL_READ_QUEUE_EVENT, currentClockCycle, 0, number, 0, 0, 0, 0);
+	}
+	else
+	{
+	    ChannelPacket *p = queue->front();
+	    event_log->record(write ? CTRL_WRITE_QUEUE_EVENT : CTRL_READ_QUEUE_EVENT, currentClockCycle, p->virtualAddress, number, 
+			      p->die, p->plane, queue->size(), p->busPacketType);
+	}
+	return;
+    }
+
     if(!write)
     {					       
 	std::string file = "CtrlReadQueue";
@@ -405,6 +592,12 @@ void Logger::log_ctrl_queue_event(bool write, uint64_t number, std::list<Channel
 void Logger::log_plane_state(uint64_t address, uint64_t package, uint64_t die, uint64_t plane, PlaneStateType op)
 {
     plane_states[package][die][plane] = op;
+
+    if(event_log != NULL)
+    {
+	event_log->record(PLANE_STATE_EVENT, currentClockCycle, address, package, die, plane, op, 0);
+	return;
+    }
     
     if(first_state_log == true)
     {
@@ -446,6 +639,14 @@ void Logger::log_plane_state(uint64_t address, uint64_t package, uint64_t die, u
     savefile.close();
 }
 
+void Logger::flush_event_log(void)
+{
+    if(event_log != NULL)
+    {
+	event_log->flush();
+    }
+}
+
 void Logger::read()
 {
 	num_accesses += 1;
@@ -458,6 +659,191 @@ void Logger::write()
 	num_writes += 1;
 }
 
+void Logger::multi_plane_op(uint64_t planes)
+{
+    num_multi_plane++;
+    multi_plane_planes += planes;
+}
+
+void Logger::suspended(void)
+{
+    num_suspends++;
+}
+
+void Logger::deadline_done(uint64_t cycle, uint64_t deadline)
+{
+    num_deadlines++;
+    if(cycle > deadline)
+    {
+	num_deadline_misses++;
+	deadline_lateness_hist.add(cycle - deadline);
+    }
+}
+
+void Logger::register_tenants(uint64_t count)
+{
+    tenant_reads = vector<uint64_t>(count, 0);
+    tenant_writes = vector<uint64_t>(count, 0);
+    tenant_read_latency = vector<Histogram>(count);
+    tenant_write_latency = vector<Histogram>(count);
+    for(uint64_t i = 0; i < count; i++)
+    {
+	stringstream prefix;
+	prefix << "tenant" << i << ".";
+	stats.counter(prefix.str()+"reads", &tenant_reads[i]);
+	stats.counter(prefix.str()+"writes", &tenant_writes[i]);
+	stats.derived(prefix.str()+"read_throughput_kbs", [this, i]() { return calc_throughput(currentClockCycle, tenant_reads[i]); });
+	stats.derived(prefix.str()+"write_throughput_kbs", [this, i]() { return calc_throughput(currentClockCycle, tenant_writes[i]); });
+	stats.histogram(prefix.str()+"read_latency", &tenant_read_latency[i]);
+	stats.histogram(prefix.str()+"write_latency", &tenant_write_latency[i]);
+    }
+}
+
+void Logger::tenant_done(uint64_t tenant, bool write, uint64_t latency)
+{
+    if(write)
+    {
+	tenant_writes[tenant]++;
+	tenant_write_latency[tenant].add(latency);
+    }
+    else
+    {
+	tenant_reads[tenant]++;
+	tenant_read_latency[tenant].add(latency);
+    }
+}
+
+void Logger::write_drain_started(void)
+{
+    num_write_drains++;
+}
+
+void Logger::read_cache_access(bool hit)
+{
+    if(hit)
+    {
+	num_read_cache_hits++;
+    }
+    else
+    {
+	num_read_cache_misses++;
+    }
+}
+
+void Logger::read_cache_evicted(void)
+{
+    num_read_cache_evictions++;
+}
+
+void Logger::write_buffer_write(bool merged, bool rewrite)
+{
+    num_buffered_writes++;
+    if(merged)
+    {
+	num_buffer_merges++;
+    }
+    if(rewrite)
+    {
+	num_buffer_rewrites++;
+    }
+}
+
+void Logger::write_buffer_forward(void)
+{
+    num_buffer_forwards++;
+}
+
+void Logger::write_buffer_fill(void)
+{
+    num_buffer_fills++;
+}
+
+void Logger::write_buffer_flush(WriteBufferFlush reason)
+{
+    num_buffer_flushes[reason]++;
+}
+
+void Logger::prefetch_issued(void)
+{
+    num_prefetches++;
+}
+
+void Logger::prefetch_used(void)
+{
+    num_prefetches_used++;
+}
+
+void Logger::prefetch_late(void)
+{
+    num_prefetches_late++;
+}
+
+void Logger::read_transfer(uint64_t bytes)
+{
+    num_read_transfers++;
+    read_transfer_bytes += bytes;
+}
+
+void Logger::sector_write(bool merged)
+{
+    num_sector_writes++;
+    if(merged)
+    {
+	num_sector_merges++;
+    }
+}
+
+void Logger::sector_program(bool gc, uint64_t sectors)
+{
+    if(gc)
+    {
+	num_gc_sector_programs++;
+	num_gc_sectors_moved += sectors;
+    }
+    else
+    {
+	num_sector_programs++;
+	num_sectors_packed += sectors;
+    }
+}
+
+void Logger::map_cache_access(bool hit)
+{
+    if(hit)
+    {
+	num_map_hits++;
+    }
+    else
+    {
+	num_map_misses++;
+    }
+}
+
+void Logger::map_read(uint64_t latency)
+{
+    num_map_reads++;
+    map_read_cycles += latency;
+}
+
+void Logger::map_write(void)
+{
+    num_map_writes++;
+}
+
+void Logger::log_block_merge(LogBlockMerge kind, uint64_t copies, uint64_t cycles)
+{
+    num_merges[kind]++;
+    merge_copies += copies;
+    merge_cycles += cycles;
+}
+
+void Logger::write_drain_window(double high, double low, double pressure)
+{
+    drain_high_watermark = high;
+    drain_low_watermark = low;
+    drain_pressure = pressure;
+}
+
 void Logger::locked_up(uint64_t cycle)
 {
     num_locks += 1;
@@ -516,16 +902,19 @@ void Logger::idle_write()
 void Logger::read_latency(uint64_t cycles)
 {
     average_read_latency += cycles;
+    read_latency_hist.add(cycles);
 }
 
 void Logger::write_latency(uint64_t cycles)
 {
     average_write_latency += cycles;
+    write_latency_hist.add(cycles);
 }
 
 void Logger::queue_latency(uint64_t cycles)
 {
     average_queue_latency += cycles;
+    queue_latency_hist.add(cycles);
 }
 
 double Logger::unmapped_rate()
@@ -732,11 +1121,7 @@ void Logger::save(uint64_t cycle, uint64_t epoch)
 	{
 	    savefile<<"\nWrite Frequency Data: \n";
 	    savefile<<"========================\n";
-	    unordered_map<uint64_t, uint64_t>::iterator it;
-	    for (it = writes_per_address.begin(); it != writes_per_address.end(); it++)
-	    {
-		savefile<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
-	    }
+	    this->write_wear(savefile);
 	}
 
 	savefile<<"\nPower Data: \n";
@@ -758,14 +1143,13 @@ void Logger::save(uint64_t cycle, uint64_t epoch)
 
 	savefile.close();
 
-	if(USE_EPOCHS && !RUNTIME_WRITE)
+	// epochs were already streamed out as they finished, just make sure they're on disk
+	if(epochfile.is_open())
 	{
-	    list<EpochEntry>::iterator it;
-	    for (it = epoch_queue.begin(); it != epoch_queue.end(); it++)
-	    {
-		write_epoch(&(*it));
-	    }
+	    epochfile.flush();
 	}
+
+	save_stats(cycle, epoch);
 }
 
 void Logger::print(uint64_t cycle) 
@@ -842,8 +1226,6 @@ void Logger::save_epoch(uint64_t cycle, uint64_t epoch)
 
     this_epoch.ftl_queue_length = ftl_queue_length;
 
-    this_epoch.writes_per_address = writes_per_address;
-
     for(uint64_t i = 0; i < ctrl_queue_length.size(); i++)
     {
 	for(uint64_t j = 0; j < ctrl_queue_length[i].size(); j++)
@@ -890,42 +1272,170 @@ void Logger::save_epoch(uint64_t cycle, uint64_t epoch)
 	}
     }
     
+    write_epoch(&this_epoch);
+
+    last_epoch = temp_epoch;
+
+    save_epoch_stats(cycle, epoch);
+}
+
+void Logger::save_stats(uint64_t cycle, uint64_t epoch)
+{
+    if(STATS_FORMAT.compare("json") == 0 || STATS_FORMAT.compare("csv") == 0)
+    {
+	stats.save(LOG_DIR+"NVDIMM_STATS."+STATS_FORMAT, STATS_FORMAT, cycle, epoch);
+    }
+}
+
+// unlike the text epoch log these are running totals, subtract neighboring rows to get the epoch
+void Logger::save_epoch_stats(uint64_t cycle, uint64_t epoch)
+{
+    if(STATS_FORMAT.compare("json") == 0 || STATS_FORMAT.compare("csv") == 0)
+    {
+	stats.save_epoch(LOG_DIR+"NVDIMM_EPOCH_STATS."+STATS_FORMAT, STATS_FORMAT, cycle, epoch);
+    }
+}
+
+void Logger::open_epoch_file(void)
+{
+    if(epochfile.is_open())
+    {
+	return;
+    }
+
+    string command_str = "test -e "+LOG_DIR+" || mkdir "+LOG_DIR;
+    const char * command = command_str.c_str();
+    int sys_done = system(command);
+    if (sys_done != 0)
+    {
+	WARNING("Something might have gone wrong when nvdimm attempted to makes its log directory");
+    }
+    epochfile.open(LOG_DIR+"NVDIMM_EPOCH.log", ios_base::out | ios_base::trunc);
+    if (!epochfile) 
+    {
+	ERROR("Cannot open NVDIMM_EPOCH.log");
+	exit(-1); 
+    }
+    epochfile<<"NVDIMM_EPOCH Log \n";
+}
+
+void Logger::close_epoch_entry(void)
+{
+    // with runtime write on each epoch goes to disk as soon as its written
+    // otherwise the stream just buffers it and it gets flushed whenever the buffer fills or at save
     if(RUNTIME_WRITE)
     {
-	write_epoch(&this_epoch);
+	epochfile.flush();
+    }
+}
+
+void Logger::wear_write(uint64_t paddr)
+{
+    if(WEAR_LEVEL_EXACT)
+    {
+	writes_per_address[paddr]++;
+	if(USE_EPOCHS)
+	{
+	    epoch_writes_per_address[paddr]++;
+	}
     }
     else
     {
-	epoch_queue.push_front(this_epoch);
+	wear->write(paddr);
     }
+}
 
-    last_epoch = temp_epoch;
+void Logger::wear_erase(uint64_t paddr)
+{
+    wear->erase(paddr);
 }
 
-void Logger::write_epoch(EpochEntry *e)
+void Logger::write_wear(std::ofstream &file)
 {
-    	if(e->epoch == 0 && RUNTIME_WRITE)
+    if(WEAR_LEVEL_EXACT)
+    {
+	unordered_map<uint64_t, uint64_t>::iterator it;
+	for (it = writes_per_address.begin(); it != writes_per_address.end(); it++)
 	{
-	    string command_str = "test -e "+LOG_DIR+" || mkdir "+LOG_DIR;
-	    const char * command = command_str.c_str();
-	    int sys_done = system(command);
-	    if (sys_done != 0)
+	    file<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
+	}
+    }
+    else
+    {
+	file<<"Total Writes Tracked: "<<wear->total_writes<<"\n";
+	file<<"Most Written Addresses (estimated): \n";
+	vector<pair<uint64_t, uint64_t> > top = wear->top_writes();
+	for(uint64_t i = 0; i < top.size(); i++)
+	{
+	    file<<"Address "<<top[i].first<<": "<<top[i].second<<" writes\n";
+	}
+    }
+
+    if(wear->total_erases > 0)
+    {
+	uint64_t min_erases = ULLONG_MAX;
+	uint64_t max_erases = 0;
+	uint64_t max_block = 0;
+	uint64_t erased_blocks = 0;
+	for(uint64_t i = 0; i < wear->block_erases.size(); i++)
+	{
+	    uint64_t e = wear->block_erases[i];
+	    if(e < min_erases)
 	    {
-		WARNING("Something might have gone wrong when nvdimm attempted to makes its log directory");
+		min_erases = e;
+	    }
+	    if(e > max_erases)
+	    {
+		max_erases = e;
+		max_block = i;
+	    }
+	    if(e > 0)
+	    {
+		erased_blocks++;
 	    }
-	    savefile.open(LOG_DIR+"NVDIMM_EPOCH.log", ios_base::out | ios_base::trunc);
-	    savefile<<"NVDIMM_EPOCH Log \n";
 	}
-	else
+
+	file<<"\nBlock Erase Data: \n";
+	file<<"========================\n";
+	file<<"Total Erases: "<<wear->total_erases<<"\n";
+	file<<"Blocks Erased At Least Once: "<<erased_blocks<<" of "<<wear->block_erases.size()<<"\n";
+	file<<"Minimum Erases Per Block: "<<min_erases<<"\n";
+	file<<"Maximum Erases Per Block: "<<max_erases<<" (block "<<max_block<<")\n";
+	file<<"Average Erases Per Block: "<<divide((double)wear->total_erases, (double)wear->block_erases.size())<<"\n";
+	if(WEAR_LEVEL_EXACT)
 	{
-	    savefile.open(LOG_DIR+"NVDIMM_EPOCH.log", ios_base::out | ios_base::app);
+	    for(uint64_t i = 0; i < wear->block_erases.size(); i++)
+	    {
+		if(wear->block_erases[i] > 0)
+		{
+		    file<<"Block "<<i<<": "<<wear->block_erases[i]<<" erases\n";
+		}
+	    }
 	}
+    }
+}
 
-	if (!savefile) 
+void Logger::write_epoch_wear(void)
+{
+    if(WEAR_LEVEL_EXACT)
+    {
+	unordered_map<uint64_t, uint64_t>::iterator it;
+	for (it = epoch_writes_per_address.begin(); it != epoch_writes_per_address.end(); it++)
 	{
-	    ERROR("Cannot open PowerStats.log");
-	    exit(-1); 
+	    epochfile<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
 	}
+	epoch_writes_per_address.clear();
+    }
+    else
+    {
+	// the sketch can't be split up by epoch so this is the running total so far
+	write_wear(epochfile);
+    }
+}
+
+void Logger::write_epoch(EpochEntry *e)
+{
+	this->open_epoch_file();
 
 	// Power stuff
 	// Total power used
@@ -954,72 +1464,68 @@ void Logger::write_epoch(EpochEntry *e)
 	    }
 	}
 
-	savefile<<"\nData for Epoch: "<<e->epoch<<"\n";
-	savefile<<"===========================\n";
-	savefile<<"\nAccess Data: \n";
-	savefile<<"========================\n";	
-	savefile<<"Cycles Simulated: "<<e->cycle<<"\n";
-	savefile<<"Accesses completed: "<<e->num_accesses<<"\n";
-	savefile<<"Reads completed: "<<e->num_reads<<"\n";
-	savefile<<"Writes completed: "<<e->num_writes<<"\n";
-	savefile<<"Number of Unmapped Accesses: " <<e->num_unmapped<<"\n";
-	savefile<<"Number of Mapped Accesses: " <<e->num_mapped<<"\n";
-	savefile<<"Number of Unmapped Reads: " <<e->num_read_unmapped<<"\n";
-	savefile<<"Number of Mapped Reads: " <<e->num_read_mapped<<"\n";
-	savefile<<"Number of Unmapped Writes: " <<e->num_write_unmapped<<"\n";
-	savefile<<"Number of Mapped Writes: " <<e->num_write_mapped<<"\n";
-
-	savefile<<"\nThroughput and Latency Data: \n";
-	savefile<<"========================\n";
-	savefile<<"Average Read Latency: " <<(divide((float)e->average_read_latency,(float)e->num_reads))<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_read_latency,(float)e->num_reads)*CYCLE_TIME)<<" ns)\n";
-	savefile<<"Average Write Latency: " <<divide((float)e->average_write_latency,(float)e->num_writes)<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_write_latency,(float)e->num_writes))*CYCLE_TIME<<" ns)\n";
-	savefile<<"Average Queue Latency: " <<divide((float)e->average_queue_latency,(float)e->num_accesses)<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_queue_latency,(float)e->num_accesses))*CYCLE_TIME<<" ns)\n";
-	savefile<<"Total Throughput: " <<this->calc_throughput(e->cycle, e->num_accesses)<<" KB/sec\n";
-	savefile<<"Read Throughput: " <<this->calc_throughput(e->cycle, e->num_reads)<<" KB/sec\n";
-	savefile<<"Write Throughput: " <<this->calc_throughput(e->cycle, e->num_writes)<<" KB/sec\n";
-
-	savefile<<"\nQueue Length Data: \n";
-	savefile<<"========================\n";
-	savefile<<"Length of Ftl Queue: " <<e->ftl_queue_length<<"\n";
+	epochfile<<"\nData for Epoch: "<<e->epoch<<"\n";
+	epochfile<<"===========================\n";
+	epochfile<<"\nAccess Data: \n";
+	epochfile<<"========================\n";	
+	epochfile<<"Cycles Simulated: "<<e->cycle<<"\n";
+	epochfile<<"Accesses completed: "<<e->num_accesses<<"\n";
+	epochfile<<"Reads completed: "<<e->num_reads<<"\n";
+	epochfile<<"Writes completed: "<<e->num_writes<<"\n";
+	epochfile<<"Number of Unmapped Accesses: " <<e->num_unmapped<<"\n";
+	epochfile<<"Number of Mapped Accesses: " <<e->num_mapped<<"\n";
+	epochfile<<"Number of Unmapped Reads: " <<e->num_read_unmapped<<"\n";
+	epochfile<<"Number of Mapped Reads: " <<e->num_read_mapped<<"\n";
+	epochfile<<"Number of Unmapped Writes: " <<e->num_write_unmapped<<"\n";
+	epochfile<<"Number of Mapped Writes: " <<e->num_write_mapped<<"\n";
+
+	epochfile<<"\nThroughput and Latency Data: \n";
+	epochfile<<"========================\n";
+	epochfile<<"Average Read Latency: " <<(divide((float)e->average_read_latency,(float)e->num_reads))<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_read_latency,(float)e->num_reads)*CYCLE_TIME)<<" ns)\n";
+	epochfile<<"Average Write Latency: " <<divide((float)e->average_write_latency,(float)e->num_writes)<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_write_latency,(float)e->num_writes))*CYCLE_TIME<<" ns)\n";
+	epochfile<<"Average Queue Latency: " <<divide((float)e->average_queue_latency,(float)e->num_accesses)<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_queue_latency,(float)e->num_accesses))*CYCLE_TIME<<" ns)\n";
+	epochfile<<"Total Throughput: " <<this->calc_throughput(e->cycle, e->num_accesses)<<" KB/sec\n";
+	epochfile<<"Read Throughput: " <<this->calc_throughput(e->cycle, e->num_reads)<<" KB/sec\n";
+	epochfile<<"Write Throughput: " <<this->calc_throughput(e->cycle, e->num_writes)<<" KB/sec\n";
+
+	epochfile<<"\nQueue Length Data: \n";
+	epochfile<<"========================\n";
+	epochfile<<"Length of Ftl Queue: " <<e->ftl_queue_length<<"\n";
 	for(uint64_t i = 0; i < e->ctrl_queue_length.size(); i++)
 	{
 	    for(uint64_t j = 0; j < e->ctrl_queue_length[i].size(); j++)
 	    {
-		savefile<<"Length of Controller Queue for Package " << i << ", Die " << j << ": "<<e->ctrl_queue_length[i][j]<<"\n";
+		epochfile<<"Length of Controller Queue for Package " << i << ", Die " << j << ": "<<e->ctrl_queue_length[i][j]<<"\n";
 	    }
 	}
 
 	if(WEAR_LEVEL_LOG)
 	{
-	    savefile<<"\nWrite Frequency Data: \n";
-	    savefile<<"========================\n";
-	    unordered_map<uint64_t, uint64_t>::iterator it;
-	    for (it = e->writes_per_address.begin(); it != e->writes_per_address.end(); it++)
-	    {
-		savefile<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
-	    }
+	    epochfile<<"\nWrite Frequency Data: \n";
+	    epochfile<<"========================\n";
+	    this->write_epoch_wear();
 	}
 
-	savefile<<"\nPower Data: \n";
-	savefile<<"========================\n";
+	epochfile<<"\nPower Data: \n";
+	epochfile<<"========================\n";
 
 	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
 	{
-	    savefile<<"Package: "<<i<<"\n";
-	    savefile<<"Accumulated Idle Energy: "<<(e->idle_energy[i] * VCC * 0.000000001)<<" mJ\n";
-	    savefile<<"Accumulated Access Energy: "<<(e->access_energy[i] * VCC * 0.000000001)<<" mJ\n";
-	    savefile<<"Total Energy: "<<(total_energy[i] * 0.000000001)<<" mJ\n\n";
+	    epochfile<<"Package: "<<i<<"\n";
+	    epochfile<<"Accumulated Idle Energy: "<<(e->idle_energy[i] * VCC * 0.000000001)<<" mJ\n";
+	    epochfile<<"Accumulated Access Energy: "<<(e->access_energy[i] * VCC * 0.000000001)<<" mJ\n";
+	    epochfile<<"Total Energy: "<<(total_energy[i] * 0.000000001)<<" mJ\n\n";
 	 
-	    savefile<<"Average Idle Power: "<<ave_idle_power[i]<<" mW\n";
-	    savefile<<"Average Access Power: "<<ave_access_power[i]<<" mW\n";
-	    savefile<<"Average Power: "<<average_power[i]<<" mW\n\n";
+	    epochfile<<"Average Idle Power: "<<ave_idle_power[i]<<" mW\n";
+	    epochfile<<"Average Access Power: "<<ave_access_power[i]<<" mW\n";
+	    epochfile<<"Average Power: "<<average_power[i]<<" mW\n\n";
 	}
 
-	savefile<<"\n-------------------------------------------------\n";
-	
-	savefile.close();
+	epochfile<<"\n-------------------------------------------------\n";
+
+	this->close_epoch_entry();
 }
 
@@ -46,6 +46,9 @@
 #include "FlashConfiguration.h"
 #include "ChannelPacket.h"
 #include "FlashTransaction.h"
+#include "EventLog.h"
+#include "WearTracker.h"
+#include "Stats.h"
 
 namespace NVDSim
 {
@@ -57,6 +60,20 @@ namespace NVDSim
 	GC_WRITING,
 	ERASING
     };
+
+    // why the write buffer sent a page to the ftl
+    enum WriteBufferFlush{
+	FULL_PAGE_FLUSH,
+	AGED_FLUSH,
+	EVICTION_FLUSH
+    };
+
+    // how the log block ftl got a log block back, see LOG_BLOCK_FTL
+    enum LogBlockMerge{
+	SWITCH_MERGE, // the log block had the whole data block in order and just took its place
+	PARTIAL_MERGE, // it had the start of it in order and the rest was copied in behind
+	FULL_MERGE // everything in it was copied out to new data blocks
+    };
     
     class Logger: public SimObj
     {
@@ -67,6 +84,7 @@ namespace NVDSim
 	void log_ftl_queue_event(bool write, std::list<FlashTransaction> *queue);
 	void log_ctrl_queue_event(bool write, uint64_t number, std::list<ChannelPacket*> *queue);
 	void log_plane_state(uint64_t address, uint64_t package, uint64_t die, uint64_t plane, PlaneStateType op);
+	void flush_event_log(void);
 	
 	// operations
 	void read();
@@ -118,9 +136,48 @@ namespace NVDSim
 	virtual void access_stop(uint64_t addr, uint64_t paddr);
 
 	virtual void save_epoch(uint64_t cycle, uint64_t epoch);
+
+	// epochs are written out as soon as they finish rather than held until the end
+	void open_epoch_file(void);
+	void close_epoch_entry(void);
+
+	// machine readable copies of the logs, see STATS_FORMAT
+	void save_stats(uint64_t cycle, uint64_t epoch);
+
+	void multi_plane_op(uint64_t planes);
+	void suspended(void);
+	void deadline_done(uint64_t cycle, uint64_t deadline);
+	// only called when there is more than one tenant, see TENANT_WEIGHTS
+	void register_tenants(uint64_t count);
+	void tenant_done(uint64_t tenant, bool write, uint64_t latency);
+	void write_drain_started(void);
+	void read_cache_access(bool hit);
+	void read_cache_evicted(void);
+	void write_buffer_write(bool merged, bool rewrite);
+	void write_buffer_forward(void);
+	void write_buffer_fill(void);
+	void write_buffer_flush(WriteBufferFlush reason);
+	void prefetch_issued(void);
+	void prefetch_used(void);
+	void prefetch_late(void);
+	void read_transfer(uint64_t bytes);
+	void sector_write(bool merged);
+	void sector_program(bool gc, uint64_t sectors);
+	void map_cache_access(bool hit);
+	void map_read(uint64_t latency);
+	void map_write(void);
+	void log_block_merge(LogBlockMerge kind, uint64_t copies, uint64_t cycles);
+	void write_drain_window(double high, double low, double pressure);
+	void save_epoch_stats(uint64_t cycle, uint64_t epoch);
+
+	void wear_write(uint64_t paddr);
+	void wear_erase(uint64_t paddr);
+	void write_wear(std::ofstream &file);
+	void write_epoch_wear(void);
 	
 	// State
 	std::ofstream savefile;
+	std::ofstream epochfile;
 
 	uint64_t num_accesses;
 	uint64_t num_reads;
@@ -129,6 +186,44 @@ namespace NVDSim
 	uint64_t num_forced;
 
 	uint64_t num_locks;
+
+	uint64_t num_multi_plane; // commands that went to more than one plane at once
+	uint64_t multi_plane_planes; // planes covered by those commands
+	uint64_t num_suspends; // erases and programs suspended for a read
+	uint64_t num_deadlines; // completed transactions that had a deadline
+	uint64_t num_deadline_misses;
+	uint64_t num_write_drains; // times a write queue went over its high watermark
+	uint64_t num_read_cache_hits;
+	uint64_t num_read_cache_misses;
+	uint64_t num_read_cache_evictions;
+	uint64_t num_buffered_writes; // host writes taken by the write buffer
+	uint64_t num_buffer_merges; // ones that went into a page that was already there
+	uint64_t num_buffer_rewrites; // ones that overwrote a line that was already there
+	uint64_t num_buffer_forwards; // reads answered from the write buffer
+	uint64_t num_buffer_fills; // reads of the rest of a partial page before it was flushed
+	std::vector<uint64_t> num_buffer_flushes; // by WriteBufferFlush
+	uint64_t num_prefetches;
+	uint64_t num_prefetches_used; // prefetched pages the host read out of the read cache
+	uint64_t num_prefetches_late; // ones the host asked for while they were still on their way
+	uint64_t num_read_transfers; // reads that came back from the dies
+	uint64_t read_transfer_bytes; // how much of their pages they brought with them
+	uint64_t num_sector_writes; // host sectors taken by the sector mapped ftl
+	uint64_t num_sector_merges; // ones that replaced a sector still waiting in its pack
+	uint64_t num_sector_programs; // pages of host sectors programmed
+	uint64_t num_sectors_packed; // host sectors those pages held
+	uint64_t num_gc_sector_programs; // pages of sectors the gc moved
+	uint64_t num_gc_sectors_moved;
+	uint64_t num_map_hits; // host pages whose map entry was already cached, see DFTL
+	uint64_t num_map_misses;
+	uint64_t num_map_reads; // pages of the mapping table read in for misses
+	uint64_t map_read_cycles; // how long the misses waited on those reads
+	uint64_t num_map_writes; // pages of the mapping table written back for dirty entries
+	std::vector<uint64_t> num_merges; // by LogBlockMerge
+	uint64_t merge_copies; // pages the merges had to copy
+	uint64_t merge_cycles; // from when each merge started until its last erase finished
+	double drain_high_watermark; // as of the last write drain window
+	double drain_low_watermark;
+	double drain_pressure;
 	uint64_t time_locked;
 	uint64_t lock_start;
 
@@ -145,13 +240,29 @@ namespace NVDSim
 	uint64_t average_write_latency;
 	uint64_t average_queue_latency;
 
+	Histogram read_latency_hist;
+	Histogram deadline_lateness_hist; // cycles past the deadline for the ones that missed
+	Histogram write_latency_hist;
+	Histogram queue_latency_hist;
+
+	// per tenant, sized once in register_tenants so the registry can hold on to them
+	std::vector<uint64_t> tenant_reads;
+	std::vector<uint64_t> tenant_writes;
+	std::vector<Histogram> tenant_read_latency; // from the host handing it over to the completion
+	std::vector<Histogram> tenant_write_latency;
+
 	uint64_t ftl_queue_length;
 	std::vector<std::vector <uint64_t> > ctrl_queue_length;
 
 	uint64_t max_ftl_queue_length;
 	std::vector<std::vector <uint64_t> > max_ctrl_queue_length;
 
+	// sketched write counts and per block erase counts, NULL if the wear log is off
+	WearTracker *wear;
+	// exact per address counts, only kept with WEAR_LEVEL_EXACT since they grow with the footprint
 	std::unordered_map<uint64_t, uint64_t> writes_per_address;
+	// only the writes since the last epoch, cleared every time an epoch is written
+	std::unordered_map<uint64_t, uint64_t> epoch_writes_per_address;
 
 	// Extended logging state
 	bool first_write_log;
@@ -162,12 +273,17 @@ namespace NVDSim
 	bool* first_crtl_write_log;
 	bool first_state_log;
 	PlaneStateType*** plane_states;
+	// binary version of the queue and plane state logs, NULL if we're writing text
+	EventLog *event_log;
 
 	// Power Stuff
 	// This is computed per package
 	std::vector<double> idle_energy;
 	std::vector<double> access_energy;
 
+	// everything the subclasses want in the machine readable output registers in here
+	StatsRegistry stats;
+
 
 	class AccessMapEntry
 	{
@@ -221,8 +337,6 @@ namespace NVDSim
 
 	    uint64_t ftl_queue_length;
 	    std::vector<std::vector<uint64_t> > ctrl_queue_length;
-	    
-	    std::unordered_map<uint64_t, uint64_t> writes_per_address;
 
 	    std::vector<double> idle_energy;
 	    std::vector<double> access_energy;
@@ -260,9 +374,6 @@ namespace NVDSim
 	// Store system snapshot from last epoch to compute this epoch
 	EpochEntry last_epoch;
 
-	// Store the data from each epoch for printing at the end of the simulation
-	std::list<EpochEntry> epoch_queue;
-
 	virtual void write_epoch(EpochEntry *e);
     };
 }
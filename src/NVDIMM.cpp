@@ -45,6 +45,11 @@ using namespace std;
 namespace NVDSim
 {
     NVDIMM::NVDIMM(uint64_t id, string deviceFile, string sysFile, string pwd, string trc) :
+	NVDIMM(id, deviceFile, sysFile, pwd, trc, vector<string>(), vector<string>())
+    {
+    }
+
+    NVDIMM::NVDIMM(uint64_t id, string deviceFile, string sysFile, string pwd, string trc, vector<string> overrideKeys, vector<string> overrideValues) :
 	dev(deviceFile),
 	sys(sysFile),
 	cDirectory(pwd)
@@ -67,6 +72,7 @@ namespace NVDSim
 	}
 	Init::ReadIniFile(dev, false);
 	//Init::ReadIniFile(sys, true);
+	Init::OverrideKeys(overrideKeys, overrideValues);
 
 	 if (!Init::CheckIfAllSet())
 	 {
@@ -119,6 +125,236 @@ namespace NVDSim
 	PRINT("");
 	
 	
+	if(MULTI_PLANE == 1 && BUFFERED == 1)
+	{
+	  WARNING("Multi-plane operations are only supported without a buffer, ignoring MULTI_PLANE");
+	  MULTI_PLANE = 0;
+	}
+
+	if(FTL_SHARDS == 0 || FTL_SHARDS > NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE)
+	{
+	  ERROR("FTL_SHARDS must be between 1 and the number of planes");
+	  exit(-1);
+	}
+
+	// a single tenant skips the tenant queues entirely
+	stringstream weights(TENANT_WEIGHTS);
+	string weight;
+	while(getline(weights, weight, ','))
+	{
+	  char *end;
+	  uint64_t w = strtoull(weight.c_str(), &end, 10);
+	  if(weight.empty() || *end != '\0' || w == 0)
+	  {
+	    ERROR("TENANT_WEIGHTS must be a comma separated list of weights greater than 0, got "<<TENANT_WEIGHTS);
+	    exit(-1);
+	  }
+	  tenant_weights.push_back(w);
+	}
+	if(tenant_weights.empty())
+	{
+	  ERROR("TENANT_WEIGHTS needs at least one weight");
+	  exit(-1);
+	}
+	if(tenant_weights.size() > 1)
+	{
+	  if(TENANT_QUEUE_LENGTH == 0)
+	  {
+	    ERROR("TENANT_QUEUE_LENGTH must be at least 1 with more than one tenant");
+	    exit(-1);
+	  }
+	  tenant_queues = vector<list<FlashTransaction> >(tenant_weights.size());
+	  tenant_deficits = vector<uint64_t>(tenant_weights.size(), 0);
+	}
+	tenant_pointer = 0;
+	tenant_waiting = false;
+
+	if(ADAPTIVE_WRITE_DRAIN && (DRAIN_LOW_WATERMARK < 0.0 || DRAIN_HIGH_WATERMARK > 1.0 || DRAIN_LOW_WATERMARK >= DRAIN_HIGH_WATERMARK))
+	{
+	  ERROR("The write drain watermarks need 0 <= DRAIN_LOW_WATERMARK < DRAIN_HIGH_WATERMARK <= 1");
+	  exit(-1);
+	}
+
+	if(ADAPTIVE_WRITE_DRAIN && DRAIN_WINDOW == 0)
+	{
+	  ERROR("DRAIN_WINDOW must be at least 1");
+	  exit(-1);
+	}
+
+	if(READ_CACHE)
+	{
+	  if(READ_CACHE_LINE_SIZE == 0 || NV_PAGE_SIZE % READ_CACHE_LINE_SIZE != 0)
+	  {
+	    ERROR("READ_CACHE_LINE_SIZE must divide NV_PAGE_SIZE");
+	    exit(-1);
+	  }
+	  if(READ_CACHE_SIZE == 0 || READ_CACHE_SIZE % READ_CACHE_LINE_SIZE != 0)
+	  {
+	    ERROR("READ_CACHE_SIZE must be a multiple of READ_CACHE_LINE_SIZE");
+	    exit(-1);
+	  }
+	  if(READ_CACHE_WAYS != 0 && (READ_CACHE_SIZE / READ_CACHE_LINE_SIZE) % READ_CACHE_WAYS != 0)
+	  {
+	    ERROR("READ_CACHE_WAYS must divide the number of lines in the read cache");
+	    exit(-1);
+	  }
+	  if(READ_CACHE_POLICY.compare("LRU") != 0 && READ_CACHE_POLICY.compare("ARC") != 0 && READ_CACHE_POLICY.compare("CLOCK") != 0)
+	  {
+	    ERROR("READ_CACHE_POLICY must be LRU, ARC or CLOCK");
+	    exit(-1);
+	  }
+	}
+
+	if(WRITE_BUFFER)
+	{
+	  if(WRITE_BUFFER_LINE_SIZE == 0 || NV_PAGE_SIZE % WRITE_BUFFER_LINE_SIZE != 0)
+	  {
+	    ERROR("WRITE_BUFFER_LINE_SIZE must divide NV_PAGE_SIZE");
+	    exit(-1);
+	  }
+	  if(WRITE_BUFFER_PAGES == 0)
+	  {
+	    ERROR("WRITE_BUFFER_PAGES must be at least 1");
+	    exit(-1);
+	  }
+	}
+
+	if(PARTIAL_READS && (SECTOR_SIZE == 0 || NV_PAGE_SIZE % SECTOR_SIZE != 0))
+	{
+	  ERROR("SECTOR_SIZE must divide NV_PAGE_SIZE");
+	  exit(-1);
+	}
+
+	if(PARTIAL_READS && READ_CACHE && SECTOR_SIZE % READ_CACHE_LINE_SIZE != 0)
+	{
+	  ERROR("READ_CACHE_LINE_SIZE must divide SECTOR_SIZE, a partial read can't fill a bigger line");
+	  exit(-1);
+	}
+
+	if(PREFETCH && !READ_CACHE)
+	{
+	  ERROR("PREFETCH needs READ_CACHE, that's where the prefetched pages go");
+	  exit(-1);
+	}
+
+	if(PREFETCH && (PREFETCH_STREAMS == 0 || PREFETCH_TRIGGER == 0 || PREFETCH_DEPTH == 0))
+	{
+	  ERROR("PREFETCH_STREAMS, PREFETCH_TRIGGER and PREFETCH_DEPTH must be at least 1");
+	  exit(-1);
+	}
+
+	if(SECTOR_MAPPING)
+	{
+	  if(!GARBAGE_COLLECT)
+	  {
+	    ERROR("SECTOR_MAPPING needs GARBAGE_COLLECT, sectors are only ever moved by the gc");
+	    exit(-1);
+	  }
+	  if(HOST_SECTOR_SIZE == 0 || NV_PAGE_SIZE % HOST_SECTOR_SIZE != 0)
+	  {
+	    ERROR("HOST_SECTOR_SIZE must divide NV_PAGE_SIZE");
+	    exit(-1);
+	  }
+	  // these all work on whole virtual pages
+	  if(READ_CACHE || WRITE_BUFFER || PARTIAL_READS || DISK_READ || ENABLE_WRITE_SCRIPT)
+	  {
+	    ERROR("SECTOR_MAPPING can't be used with READ_CACHE, WRITE_BUFFER, PARTIAL_READS, DISK_READ or ENABLE_WRITE_SCRIPT");
+	    exit(-1);
+	  }
+	  if(ENABLE_NV_SAVE == 1 || ENABLE_NV_RESTORE == 1)
+	  {
+	    WARNING("Saving and restoring the nv state is not supported with SECTOR_MAPPING, ignoring ENABLE_NV_SAVE and ENABLE_NV_RESTORE");
+	    ENABLE_NV_SAVE = 0;
+	    ENABLE_NV_RESTORE = 0;
+	  }
+	}
+
+	if(DFTL)
+	{
+	  if(!GARBAGE_COLLECT)
+	  {
+	    ERROR("DFTL needs GARBAGE_COLLECT, the pages of the mapping table get moved by the gc like any others");
+	    exit(-1);
+	  }
+	  if(SECTOR_MAPPING)
+	  {
+	    ERROR("DFTL can't be used with SECTOR_MAPPING");
+	    exit(-1);
+	  }
+	  if(MAP_CACHE_ENTRIES == 0)
+	  {
+	    ERROR("MAP_CACHE_ENTRIES must be at least 1");
+	    exit(-1);
+	  }
+	  if(MAP_ENTRY_SIZE == 0 || NV_PAGE_SIZE % MAP_ENTRY_SIZE != 0)
+	  {
+	    ERROR("MAP_ENTRY_SIZE must divide NV_PAGE_SIZE");
+	    exit(-1);
+	  }
+	  if(ENABLE_NV_SAVE == 1 || ENABLE_NV_RESTORE == 1)
+	  {
+	    WARNING("Saving and restoring the nv state is not supported with DFTL, ignoring ENABLE_NV_SAVE and ENABLE_NV_RESTORE");
+	    ENABLE_NV_SAVE = 0;
+	    ENABLE_NV_RESTORE = 0;
+	  }
+	}
+
+	if(LOG_BLOCK_FTL)
+	{
+	  if(!GARBAGE_COLLECT)
+	  {
+	    ERROR("LOG_BLOCK_FTL needs GARBAGE_COLLECT, the merges go through the gc");
+	    exit(-1);
+	  }
+	  if(SECTOR_MAPPING || DFTL)
+	  {
+	    ERROR("LOG_BLOCK_FTL can't be used with SECTOR_MAPPING or DFTL");
+	    exit(-1);
+	  }
+	  if(LOG_BLOCK_SCHEME.compare("BAST") != 0 && LOG_BLOCK_SCHEME.compare("FAST") != 0)
+	  {
+	    ERROR("LOG_BLOCK_SCHEME must be BAST or FAST");
+	    exit(-1);
+	  }
+	  // FAST keeps one of them for sequential writes
+	  if(LOG_BLOCKS == 0 || (LOG_BLOCK_SCHEME.compare("FAST") == 0 && LOG_BLOCKS < 2))
+	  {
+	    ERROR("LOG_BLOCKS must be at least 1 with BAST and at least 2 with FAST");
+	    exit(-1);
+	  }
+	  // the log blocks and the block a merge copies into come out of the overprovisioning
+	  if((BLOCKS_PER_PLANE - VIRTUAL_BLOCKS_PER_PLANE) * PLANES_PER_DIE * DIES_PER_PACKAGE * NUM_PACKAGES < LOG_BLOCKS + 1)
+	  {
+	    ERROR("LOG_BLOCK_FTL needs at least LOG_BLOCKS + 1 spare blocks, raise PBLOCKS_PER_VBLOCK");
+	    exit(-1);
+	  }
+	  // a logical block lives in one shard's blocks
+	  if(FTL_SHARDS > 1)
+	  {
+	    ERROR("LOG_BLOCK_FTL can't be used with more than one ftl shard");
+	    exit(-1);
+	  }
+	  // these pick their own pages
+	  if(DISK_READ || ENABLE_WRITE_SCRIPT)
+	  {
+	    ERROR("LOG_BLOCK_FTL can't be used with DISK_READ or ENABLE_WRITE_SCRIPT");
+	    exit(-1);
+	  }
+	  if(ENABLE_NV_SAVE == 1 || ENABLE_NV_RESTORE == 1)
+	  {
+	    WARNING("Saving and restoring the nv state is not supported with LOG_BLOCK_FTL, ignoring ENABLE_NV_SAVE and ENABLE_NV_RESTORE");
+	    ENABLE_NV_SAVE = 0;
+	    ENABLE_NV_RESTORE = 0;
+	  }
+	}
+
+	if(FTL_SHARDS > 1 && (ENABLE_NV_SAVE == 1 || ENABLE_NV_RESTORE == 1))
+	{
+	  WARNING("Saving and restoring the nv state is not supported with more than one ftl shard, ignoring ENABLE_NV_SAVE and ENABLE_NV_RESTORE");
+	  ENABLE_NV_SAVE = 0;
+	  ENABLE_NV_RESTORE = 0;
+	}
+
 	if((GARBAGE_COLLECT == 0) && (DEVICE_TYPE.compare("NAND") == 0 || DEVICE_TYPE.compare("NOR") == 0))
 	{
 	  ERROR("Device is Flash and must use garbage collection");
@@ -165,7 +401,25 @@ namespace NVDSim
 		log = NULL;
 	    }
 	    controller= new Controller(this, log);
-	    ftl = new GCFtl(controller, log, this);
+	    for (i = 0; i < FTL_SHARDS; i++)
+	    {
+		if(SECTOR_MAPPING)
+		{
+		    ftls.push_back(new SectorFtl(controller, log, this, i));
+		}
+		else if(DFTL)
+		{
+		    ftls.push_back(new DFtl(controller, log, this, i));
+		}
+		else if(LOG_BLOCK_FTL)
+		{
+		    ftls.push_back(new LogFtl(controller, log, this, i));
+		}
+		else
+		{
+		    ftls.push_back(new GCFtl(controller, log, this, i));
+		}
+	    }
 	}
 	else if(DEVICE_TYPE.compare("P8P") == 0 && GARBAGE_COLLECT == 0)
 	{
@@ -178,7 +432,10 @@ namespace NVDSim
 		log = NULL;
 	    }
 	    controller= new Controller(this, log);
-	    ftl = new Ftl(controller, log, this);
+	    for (i = 0; i < FTL_SHARDS; i++)
+	    {
+		ftls.push_back(new Ftl(controller, log, this, i));
+	    }
 	}
 	else if(GARBAGE_COLLECT == 1)
 	{
@@ -191,7 +448,25 @@ namespace NVDSim
 		log = NULL;
 	    }
 	    controller= new Controller(this, log);
-	    ftl = new GCFtl(controller, log, this);
+	    for (i = 0; i < FTL_SHARDS; i++)
+	    {
+		if(SECTOR_MAPPING)
+		{
+		    ftls.push_back(new SectorFtl(controller, log, this, i));
+		}
+		else if(DFTL)
+		{
+		    ftls.push_back(new DFtl(controller, log, this, i));
+		}
+		else if(LOG_BLOCK_FTL)
+		{
+		    ftls.push_back(new LogFtl(controller, log, this, i));
+		}
+		else
+		{
+		    ftls.push_back(new GCFtl(controller, log, this, i));
+		}
+	    }
 	}
 	else
 	{
@@ -204,8 +479,19 @@ namespace NVDSim
 		log = NULL;
 	    }
 	    controller= new Controller(this, log);
-	    ftl = new Ftl(controller, log, this);
+	    for (i = 0; i < FTL_SHARDS; i++)
+	    {
+		ftls.push_back(new Ftl(controller, log, this, i));
+	    }
 	}
+	// the first shard doubles as the ftl for everything that doesn't care about addresses
+	ftl = ftls[0];
+
+	if(LOGGING && tenant_queues.size() > 1)
+	{
+	    log->register_tenants(tenant_queues.size());
+	}
+
 	packages= new vector<Package>();
 
 	if (DIES_PER_PACKAGE > INT_MAX){
@@ -235,8 +521,17 @@ namespace NVDSim
 	frontBuffer = new FrontBuffer(this, ftl);
 	controller->attachFrontBuffer(frontBuffer);
 
+	writeDrain = new WriteDrain(this, log);
+	readCache = READ_CACHE ? new ReadCache(log) : NULL;
+	writeBuffer = WRITE_BUFFER ? new WriteBuffer(this, log) : NULL;
+	prefetcher = PREFETCH ? new Prefetcher(this, log) : NULL;
+
 	ReturnReadData= NULL;
 	WriteDataDone= NULL;
+	ReadyToAccept= NULL;
+	CriticalLineDone= NULL;
+	completion_queue= false;
+	ftl_waiting= false;
 
 	epoch_count = 0;
 	epoch_cycles = 0;
@@ -283,28 +578,242 @@ namespace NVDSim
 	return new NVDIMM(id, deviceFile, sysFile, pwd, trc);
     }
 
+    NVDIMM *getNVDIMMInstance(uint64_t id, string deviceFile, string sysFile, string pwd, string trc, vector<string> overrideKeys, vector<string> overrideValues)
+    {
+	return new NVDIMM(id, deviceFile, sysFile, pwd, trc, overrideKeys, overrideValues);
+    }
+
     bool NVDIMM::add(FlashTransaction &trans){
+	trans.timeAdded = currentClockCycle;
+	return addHeld(trans);
+    }
+
+    bool NVDIMM::addHeld(FlashTransaction &trans){
+	// the ftl maps whole pages so a partial read goes in as a read of its page, the offset comes back out in readDone
+	// the write buffer only ever hands the ftl whole pages so with it every read has to look up its page
+	if(trans.transactionType == DATA_READ && ((PARTIAL_READS && trans.size != 0) || WRITE_BUFFER) && trans.address % NV_PAGE_SIZE != 0)
+	{
+	    trans.offset += trans.address % NV_PAGE_SIZE;
+	    trans.address -= trans.address % NV_PAGE_SIZE;
+	}
+	// the rest of the nvdimm counts on a read staying inside its page
+	if(trans.offset >= NV_PAGE_SIZE)
+	{
+	    ERROR("Read at offset "<<trans.offset<<" starts past the end of its "<<NV_PAGE_SIZE<<" byte page");
+	    exit(-1);
+	}
+	trans.size = min(trans.size, NV_PAGE_SIZE - trans.offset);
+	if(tenant_queues.size() > 1)
+	{
+	    if(trans.tenant >= tenant_queues.size())
+	    {
+		ERROR("Transaction for tenant "<<trans.tenant<<" but TENANT_WEIGHTS only has "<<tenant_queues.size()<<" tenants");
+		exit(-1);
+	    }
+	    if(tenant_queues[trans.tenant].size() < TENANT_QUEUE_LENGTH)
+	    {
+		tenant_queues[trans.tenant].push_back(trans);
+		return true;
+	    }
+	    tenant_waiting = true;
+	    return false;
+	}
+
+	if(addToDevice(trans))
+	{
+	    return true;
+	}
+	// whoever turned the transaction away remembers it so it can call back when it has room
 	if(FRONT_BUFFER)
 	{
-	    return frontBuffer->addTransaction(trans);
+	    frontBuffer->host_waiting = true;
 	}
 	else
 	{
-	    return ftl->addTransaction(trans);
+	    ftlFor(trans.address)->host_waiting = true;
+	}
+	return false;
+    }
+
+    bool NVDIMM::addToDevice(FlashTransaction &trans){
+	bool added = FRONT_BUFFER ? frontBuffer->addTransaction(trans) : sendToFtl(trans);
+	if(added && ADAPTIVE_WRITE_DRAIN)
+	{
+	    writeDrain->arrived(trans.transactionType == DATA_READ);
+	}
+	return added;
+    }
+
+    // everything on its way into the ftl comes through here so the read cache sees it first
+    bool NVDIMM::sendToFtl(FlashTransaction &trans){
+	uint64_t page = trans.address - (trans.address % NV_PAGE_SIZE);
+	// the buffer answers the read if it has every line the read wants, otherwise the flash's copy is read and the buffered lines go on top
+	if(WRITE_BUFFER && trans.transactionType == DATA_READ &&
+	   ((PARTIAL_READS && trans.size != 0) ? writeBuffer->forward(page, trans.offset, trans.size) : writeBuffer->forward(page, 0, NV_PAGE_SIZE)))
+	{
+	    dram_accesses.push_back(make_pair(currentClockCycle + WRITE_BUFFER_LATENCY, trans));
+	    return true;
+	}
+	if(READ_CACHE && trans.transactionType == DATA_READ)
+	{
+	    // a write that comes in while this is out makes whatever it brings back too old to cache
+	    trans.cache_generation = readCache->generation();
+	    // a partial read only needs its own bytes to be there
+	    bool hit = (PARTIAL_READS && trans.size != 0) ? readCache->lookup(page + trans.offset, min(trans.size, NV_PAGE_SIZE - trans.offset)) :
+		readCache->lookup(page, NV_PAGE_SIZE);
+	    if(hit)
+	    {
+		dram_accesses.push_back(make_pair(currentClockCycle + READ_CACHE_HIT_LATENCY, trans));
+	    }
+	    else if(!ftlFor(trans.address)->addTransaction(trans))
+	    {
+		return false;
+	    }
+	    if(LOGGING)
+	    {
+		log->read_cache_access(hit);
+	    }
+	    if(PREFETCH)
+	    {
+		prefetcher->access(page, hit);
+	    }
+	    return true;
+	}
+
+	// the write is done as far as the host is concerned once it's in the buffer
+	if(WRITE_BUFFER && trans.transactionType == DATA_WRITE)
+	{
+	    if(!writeBuffer->write(trans))
+	    {
+		return false;
+	    }
+	    dram_accesses.push_back(make_pair(currentClockCycle + WRITE_BUFFER_LATENCY, trans));
+	}
+	else if(!ftlFor(trans.address)->addTransaction(trans))
+	{
+	    return false;
+	}
+	if(READ_CACHE && trans.transactionType == DATA_WRITE)
+	{
+	    readCache->invalidate(page, NV_PAGE_SIZE);
+	}
+	return true;
+    }
+
+    void NVDIMM::finishDramAccesses(void){
+	list<pair<uint64_t, FlashTransaction> >::iterator it = dram_accesses.begin();
+	while(it != dram_accesses.end())
+	{
+	    FlashTransaction &trans = it->second;
+	    if(it->first > currentClockCycle)
+	    {
+		it++;
+		continue;
+	    }
+
+	    if(trans.transactionType == DATA_WRITE)
+	    {
+		writeDone(trans, currentClockCycle);
+	    }
+	    else if(FRONT_BUFFER)
+	    {
+		// the data still has to go back over the response channel
+		trans.transactionType = RETURN_DATA;
+		if(!frontBuffer->addTransaction(trans))
+		{
+		    return;
+		}
+	    }
+	    else
+	    {
+		readDone(trans, currentClockCycle, true);
+	    }
+	    it = dram_accesses.erase(it);
+	}
+    }
+
+    // deficit round robin with a cost of one per transaction
+    // a tenant gets its weight worth of transactions each time its turn comes around
+    // and we keep our place whenever the nvdimm is full so nobody loses their turn to it
+    void NVDIMM::admitTenants(void){
+	uint64_t idle = 0;
+	while(idle < tenant_queues.size())
+	{
+	    list<FlashTransaction> &queue = tenant_queues[tenant_pointer];
+	    if(queue.empty())
+	    {
+		tenant_deficits[tenant_pointer] = 0;
+		tenant_pointer = (tenant_pointer + 1) % tenant_queues.size();
+		idle++;
+		continue;
+	    }
+	    idle = 0;
+
+	    if(tenant_deficits[tenant_pointer] == 0)
+	    {
+		tenant_deficits[tenant_pointer] = tenant_weights[tenant_pointer];
+	    }
+	    if(!addToDevice(queue.front()))
+	    {
+		return;
+	    }
+	    queue.pop_front();
+	    tenant_deficits[tenant_pointer]--;
+	    if(tenant_waiting)
+	    {
+		tenant_waiting = false;
+		readyToAccept();
+	    }
+
+	    if(tenant_deficits[tenant_pointer] == 0 || queue.empty())
+	    {
+		tenant_deficits[tenant_pointer] = 0;
+		tenant_pointer = (tenant_pointer + 1) % tenant_queues.size();
+	    }
 	}
     }
 
     bool NVDIMM::addTransaction(bool isWrite, uint64_t addr){
 	TransactionType type = isWrite ? DATA_WRITE : DATA_READ;
 	FlashTransaction trans = FlashTransaction(type, addr, NULL);
-	if(FRONT_BUFFER)
-	{
-	    return frontBuffer->addTransaction(trans);
-	}
-	else
+	return add(trans);
+    }
+
+    bool NVDIMM::addTransaction(bool isWrite, uint64_t addr, uint64_t deadline){
+	TransactionType type = isWrite ? DATA_WRITE : DATA_READ;
+	FlashTransaction trans = FlashTransaction(type, addr, NULL, deadline);
+	return add(trans);
+    }
+
+    bool NVDIMM::addTransaction(bool isWrite, uint64_t addr, uint64_t deadline, uint64_t tenant){
+	TransactionType type = isWrite ? DATA_WRITE : DATA_READ;
+	FlashTransaction trans = FlashTransaction(type, addr, NULL, deadline);
+	trans.tenant = tenant;
+	return add(trans);
+    }
+
+    bool NVDIMM::addPartialRead(uint64_t addr, uint64_t size){
+	FlashTransaction trans = FlashTransaction(DATA_READ, addr, NULL);
+	trans.size = size;
+	return add(trans);
+    }
+
+    // stop at the first one that doesn't fit so the transactions still go in the order the host gave them
+    uint64_t NVDIMM::addTransactions(const bool *isWrite, const uint64_t *addrs, uint64_t count){
+	FlashTransaction trans;
+	for(uint64_t i = 0; i < count; i++)
 	{
-	    return ftl->addTransaction(trans);
+	    trans = FlashTransaction(isWrite[i] ? DATA_WRITE : DATA_READ, addrs[i], NULL);
+	    if(!add(trans))
+	    {
+		return i;
+	    }
 	}
+	return count;
+    }
+
+    bool NVDIMM::setWriteDrain(double high, double low){
+	return writeDrain->setWatermarks(high, low);
     }
 
     string NVDIMM::SetOutputFileName(string tracefilename){
@@ -326,6 +835,141 @@ namespace NVDSim
 	ReturnPowerData = Power;
     }
 
+    void NVDIMM::RegisterReadyCallback(Callback_t *readyCB)
+    {
+	ReadyToAccept = readyCB;
+    }
+
+    // there is no address for this one so it is always 0
+    void NVDIMM::readyToAccept(void)
+    {
+	if(ReadyToAccept != NULL)
+	{
+	    (*ReadyToAccept)(systemID, 0, currentClockCycle, true);
+	}
+    }
+
+    void NVDIMM::RegisterCompletionQueue(uint64_t size)
+    {
+	completion_queue = true;
+	completions.reserve(size);
+	drained.reserve(size);
+    }
+
+    // swap the buffers so the host can read the records without us writing over them
+    uint64_t NVDIMM::drainCompletions(const CompletionRecord **records)
+    {
+	drained.swap(completions);
+	completions.clear();
+	*records = drained.data();
+	return drained.size();
+    }
+
+    void NVDIMM::readDone(const FlashTransaction &trans, uint64_t cycle, bool mapped)
+    {
+	if(trans.origin == WRITE_BUFFER_ORIGIN)
+	{
+	    writeBuffer->fillDone(trans.address);
+	    return;
+	}
+	if(trans.origin == MAP_ORIGIN)
+	{
+	    ftlFor(trans.address)->mapReadDone(trans.address);
+	    return;
+	}
+	if(trans.origin == PREFETCH_ORIGIN)
+	{
+	    // the host may have written the page since the prefetch went out
+	    if(mapped && !readCache->invalidatedSince(trans.address, trans.cache_generation) && !(WRITE_BUFFER && writeBuffer->holds(trans.address)))
+	    {
+		readCache->fill(trans.address, NV_PAGE_SIZE);
+	    }
+	    prefetcher->filled(trans.address);
+	    return;
+	}
+	// nothing happens if it was a hit and is already there
+	// a partial read only brought the sectors it needed with it
+	// the newest copy of a page the write buffer holds is there, not on the flash, so it never gets cached
+	if(READ_CACHE && mapped && !readCache->invalidatedSince(trans.address, trans.cache_generation) &&
+	   !(WRITE_BUFFER && writeBuffer->holds(trans.address - (trans.address % NV_PAGE_SIZE))))
+	{
+	    uint64_t start = (PARTIAL_READS && trans.size != 0) ? trans.offset - (trans.offset % SECTOR_SIZE) : 0;
+	    readCache->fill(trans.address - (trans.address % NV_PAGE_SIZE) + start, trans.transferSize());
+	}
+	requestDone(false, cycle, trans.deadline, trans.tenant, trans.timeAdded);
+	if(completion_queue)
+	{
+	    CompletionRecord record = {READ_COMPLETION, trans.address + trans.offset, cycle, mapped};
+	    completions.push_back(record);
+	}
+	else if(ReturnReadData != NULL)
+	{
+	    (*ReturnReadData)(systemID, trans.address + trans.offset, cycle, mapped);
+	}
+	numReads++;
+    }
+
+    void NVDIMM::critLineDone(uint64_t vAddr, uint64_t cycle)
+    {
+	if(completion_queue)
+	{
+	    CompletionRecord record = {CRIT_LINE_COMPLETION, vAddr, cycle, true};
+	    completions.push_back(record);
+	}
+	else if(CriticalLineDone != NULL)
+	{
+	    (*CriticalLineDone)(systemID, vAddr, cycle, true);
+	}
+    }
+
+    void NVDIMM::writeDone(const FlashTransaction &trans, uint64_t cycle)
+    {
+	// the host already heard about these when they went into the write buffer
+	// and a packed page is answered sector by sector by its ftl
+	// nobody outside the ftl asked for a page of the mapping table
+	if(trans.origin == WRITE_BUFFER_ORIGIN || trans.origin == SECTOR_PACK_ORIGIN || trans.origin == MAP_ORIGIN)
+	{
+	    return;
+	}
+	requestDone(true, cycle, trans.deadline, trans.tenant, trans.timeAdded);
+	if(completion_queue)
+	{
+	    CompletionRecord record = {WRITE_COMPLETION, trans.address, cycle, true};
+	    completions.push_back(record);
+	}
+	else if(WriteDataDone != NULL)
+	{
+	    (*WriteDataDone)(systemID, trans.address, cycle, true);
+	}
+    }
+
+    void NVDIMM::writeDone(const ChannelPacket *packet, uint64_t cycle)
+    {
+	if(packet->origin == SECTOR_PACK_ORIGIN)
+	{
+	    ftlFor(packet->virtualAddress)->packedWriteDone(packet->physicalAddress, cycle);
+	    return;
+	}
+	writeDone(FlashTransaction(DATA_WRITE, packet), cycle);
+    }
+
+    // per request stats that don't care whether the host uses callbacks or the completion queue
+    void NVDIMM::requestDone(bool write, uint64_t cycle, uint64_t deadline, uint64_t tenant, uint64_t timeAdded)
+    {
+	if(!LOGGING)
+	{
+	    return;
+	}
+	if(deadline != 0)
+	{
+	    log->deadline_done(cycle, deadline);
+	}
+	if(tenant_queues.size() > 1)
+	{
+	    log->tenant_done(tenant, write, cycle - timeAdded);
+	}
+    }
+
     void NVDIMM::printStats(void){
 	if(LOGGING == true)
 	{
@@ -336,16 +980,60 @@ namespace NVDSim
     void NVDIMM::saveStats(void){
 	if(LOGGING == true)
 	{
+	    log->flush_event_log();
 	    log->save(currentClockCycle, epoch_count);
 	}
 	ftl->saveNVState();
     }
 
+    // pick the shard that owns this address
+    // the page number is hashed so that strided access patterns still spread across the shards
+    Ftl *NVDIMM::ftlFor(uint64_t vAddr)
+    {
+	if(FTL_SHARDS == 1)
+	{
+	    return ftl;
+	}
+	// past the end of the host's space are the pages of the mapping table, see DFTL
+	// those are dealt out to the shards in turn
+	if(vAddr >= VIRTUAL_TOTAL_SIZE * 1024)
+	{
+	    return ftls[((vAddr - VIRTUAL_TOTAL_SIZE * 1024) / NV_PAGE_SIZE) % FTL_SHARDS];
+	}
+	uint64_t page = vAddr / NV_PAGE_SIZE;
+	return ftls[((page * 0x9E3779B97F4A7C15ULL) >> 32) % FTL_SHARDS];
+    }
+
     void NVDIMM::update(void)
     {
 	uint64_t i, j;
 	Package package;
 
+	if(tenant_queues.size() > 1)
+	{
+	    admitTenants();
+	}
+
+	if(ADAPTIVE_WRITE_DRAIN)
+	{
+	    writeDrain->update();
+	}
+
+	if(READ_CACHE || WRITE_BUFFER)
+	{
+	    finishDramAccesses();
+	}
+
+	if(WRITE_BUFFER)
+	{
+	    writeBuffer->update();
+	}
+
+	if(PREFETCH)
+	{
+	    prefetcher->update();
+	}
+
 	//update the system clock counters
 	system_clock_counter += SYSTEM_CYCLE;
 
@@ -354,8 +1042,12 @@ namespace NVDSim
 	    nv_clock_counter1 += CYCLE_TIME;
 
 	    //cout << "updating ftl \n";
-	    ftl->update();
-	    ftl->step();
+	    // the shards only share the controller so each one could be stepped on its own host thread
+	    for (i= 0; i < ftls.size(); i++)
+	    {
+		ftls[i]->update();
+		ftls[i]->step();
+	    }
 	    
 	    if(BUFFERED)
 	    {
@@ -480,7 +1172,10 @@ namespace NVDSim
 	    //saving stats at the end of each epoch
 	    if(USE_EPOCHS)
 	    {
-		ftl->sendQueueLength();
+		for (i= 0; i < ftls.size(); i++)
+		{
+		    ftls[i]->sendQueueLength();
+		}
 		controller->sendQueueLength();
 		if(epoch_cycles >= EPOCH_CYCLES)
 		{
@@ -520,22 +1215,52 @@ namespace NVDSim
 	NV_SAVE_FILE = filename;
 	cout << "got to save state in nvdimm \n";
 	cout << "save file was " << NV_SAVE_FILE << "\n";
+	if(FTL_SHARDS > 1)
+	{
+	    WARNING("Saving the nv state is not supported with more than one ftl shard");
+	    ENABLE_NV_SAVE = 0;
+	    return;
+	}
 	ftl->saveNVState();
     }
 
     void NVDIMM::loadNVState(string filename){
 	ENABLE_NV_RESTORE = 1;
 	NV_RESTORE_FILE = filename;
+	if(FTL_SHARDS > 1)
+	{
+	    WARNING("Restoring the nv state is not supported with more than one ftl shard");
+	    ENABLE_NV_RESTORE = 0;
+	    return;
+	}
 	ftl->loadNVState();
     }
 
     void NVDIMM::queuesNotFull(void)
     {
-	ftl->queuesNotFull();
+	ftl_waiting = false;
+	// the controller queues are shared so any shard may have been waiting on them
+	for (uint64_t i = 0; i < ftls.size(); i++)
+	{
+	    ftls[i]->queuesNotFull();
+	}
     }
 
     void NVDIMM::GCReadDone(uint64_t vAddr)
     {
-	ftl->GCReadDone(vAddr);
+	ftlFor(vAddr)->GCReadDone(vAddr);
+    }
+
+    void NVDIMM::eraseDone(uint64_t pAddr)
+    {
+	numErases++;
+	for (uint64_t i = 0; i < ftls.size(); i++)
+	{
+	    if (ftls[i]->ownsBlock(pAddr / BLOCK_SIZE))
+	    {
+		ftls[i]->eraseDone();
+		break;
+	    }
+	}
     }
 }
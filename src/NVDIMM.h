@@ -41,14 +41,22 @@
 #include "Controller.h"
 #include "Ftl.h"
 #include "GCFtl.h"
+#include "SectorFtl.h"
+#include "DFtl.h"
+#include "LogFtl.h"
 #include "Die.h"
 #include "FlashTransaction.h"
 #include "Callbacks.h"
+#include "CompletionRecord.h"
 #include "Logger.h"
 #include "GCLogger.h"
 #include "P8PLogger.h"
 #include "P8PGCLogger.h"
 #include "FrontBuffer.h"
+#include "WriteDrain.h"
+#include "ReadCache.h"
+#include "WriteBuffer.h"
+#include "Prefetcher.h"
 #include "Util.h"
 
 using std::string;
@@ -59,14 +67,36 @@ namespace NVDSim{
 	class NVDIMM : public SimObj{
 		public:
 			NVDIMM(uint64_t id, string dev, string sys, string pwd, string trc);
+			NVDIMM(uint64_t id, string dev, string sys, string pwd, string trc, vector<string> overrideKeys, vector<string> overrideValues);
 			void update(void);
 			bool add(FlashTransaction &trans);
+			// for a request the host made a while ago, its timeAdded is kept so the wait counts toward its latency
+			bool addHeld(FlashTransaction &trans);
 			bool addTransaction(bool isWrite, uint64_t addr);
+			bool addTransaction(bool isWrite, uint64_t addr, uint64_t deadline);
+			bool addTransaction(bool isWrite, uint64_t addr, uint64_t deadline, uint64_t tenant);
+			bool addPartialRead(uint64_t addr, uint64_t size);
+			uint64_t addTransactions(const bool *isWrite, const uint64_t *addrs, uint64_t count);
+			// moves the bounds of the adaptive write drain, both are fractions of a write queue
+			bool setWriteDrain(double high, double low);
 			void printStats(void);
 			void saveStats(void);
 			string SetOutputFileName(string tracefilename);
 			void RegisterCallbacks(Callback_t *readDone, Callback_t *writeDone, Callback_v *Power);
 			void RegisterCallbacks(Callback_t *readDone, Callback_t *critLine, Callback_t *writeDone, Callback_v *Power); 
+			// called once after an add has been turned away as soon as there is room again
+			void RegisterReadyCallback(Callback_t *ready);
+			void readyToAccept(void);
+			void RegisterCompletionQueue(uint64_t size);
+			uint64_t drainCompletions(const CompletionRecord **records);
+
+			// every completion goes through these so they can go to the callbacks or the completion queue
+			// the transaction or packet is only used for its address and request info
+			void readDone(const FlashTransaction &trans, uint64_t cycle, bool mapped);
+			void critLineDone(uint64_t vAddr, uint64_t cycle);
+			void writeDone(const FlashTransaction &trans, uint64_t cycle);
+			void writeDone(const ChannelPacket *packet, uint64_t cycle);
+			void requestDone(bool write, uint64_t cycle, uint64_t deadline, uint64_t tenant, uint64_t timeAdded);
 
 			void powerCallback(void);
 
@@ -76,11 +106,20 @@ namespace NVDSim{
 			void queuesNotFull(void);
 
 			void GCReadDone(uint64_t vAddr);
+			void eraseDone(uint64_t pAddr);
+
+			Ftl *ftlFor(uint64_t vAddr);
+			bool sendToFtl(FlashTransaction &trans);
 
 			Controller *controller;
 			Ftl *ftl;
+			vector<Ftl *> ftls;
 			Logger *log;
 			FrontBuffer  *frontBuffer;
+			WriteDrain *writeDrain;
+			ReadCache *readCache; // NULL unless READ_CACHE is on
+			WriteBuffer *writeBuffer; // NULL unless WRITE_BUFFER is on
+			Prefetcher *prefetcher; // NULL unless PREFETCH is on
 
 			vector<Package> *packages;
 
@@ -88,6 +127,11 @@ namespace NVDSim{
 			Callback_t* CriticalLineDone;
 			Callback_t* WriteDataDone;
 			Callback_v* ReturnPowerData;
+			Callback_t* ReadyToAccept;
+
+			// set when an ftl slot stalls on a full controller queue so the controller
+			// only calls queuesNotFull when someone is actually waiting on it
+			bool ftl_waiting;
 
 			uint64_t systemID, numReads, numWrites, numErases;
 			uint64_t epoch_count, epoch_cycles;
@@ -100,8 +144,30 @@ namespace NVDSim{
 
 		private:
 			string dev, sys, cDirectory;
+
+			bool addToDevice(FlashTransaction &trans);
+			void admitTenants(void);
+			void finishDramAccesses(void);
+
+			// reads answered by the read cache or the write buffer and writes taken by the write buffer
+			// along with the cycle they're done
+			list<pair<uint64_t, FlashTransaction> > dram_accesses;
+
+			// with more than one tenant each one gets its own queue in front of the nvdimm
+			// and deficit round robin decides whose transactions go in next
+			vector<list<FlashTransaction> > tenant_queues;
+			vector<uint64_t> tenant_weights;
+			vector<uint64_t> tenant_deficits;
+			uint64_t tenant_pointer;
+			bool tenant_waiting;
+
+			// completions since the last drain and the ones the host is currently looking at
+			bool completion_queue;
+			vector<CompletionRecord> completions;
+			vector<CompletionRecord> drained;
 	};
 
 	NVDIMM *getNVDIMMInstance(uint64_t id, string deviceFile, string sysFile, string pwd, string trc);
+	NVDIMM *getNVDIMMInstance(uint64_t id, string deviceFile, string sysFile, string pwd, string trc, vector<string> overrideKeys, vector<string> overrideValues);
 }
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "Callbacks.h"
+#include "CompletionRecord.h"
 
 #include <iostream>
 #include <cstdlib>
@@ -27,16 +28,56 @@ namespace NVDSim
     public:
 	void update(void);
 	bool addTransaction(bool isWrite, uint64_t addr);
+	// deadline is in the same cycles the callbacks report, only used with DEADLINE_SCHEDULE
+	bool addTransaction(bool isWrite, uint64_t addr, uint64_t deadline);
+	// tenant picks one of the queues in TENANT_WEIGHTS, use a deadline of 0 for none
+	bool addTransaction(bool isWrite, uint64_t addr, uint64_t deadline, uint64_t tenant);
+	// reads size bytes from addr, with PARTIAL_READS only the sectors they are in come off the die
+	// a size of 0 reads the whole page, the read callback gets addr back
+	bool addPartialRead(uint64_t addr, uint64_t size);
+	// adds transactions in order until one is turned away, returns how many got in
+	uint64_t addTransactions(const bool *isWrite, const uint64_t *addrs, uint64_t count);
+	// moves the bounds of ADAPTIVE_WRITE_DRAIN while running, both are fractions of a write queue
+	bool setWriteDrain(double high, double low);
 	void printStats(void);
 	void saveStats(void);
 	void RegisterCallbacks(Callback_t *readDone, Callback_t *writeDone, Callback_v *Power);
 	void RegisterCallbacks(Callback_t *readDone, Callback_t *critLine, Callback_t *writeDone, Callback_v *Power); 
+	// after add returns false this is called once as soon as there is room again
+	// so the host can hold its request instead of retrying every cycle
+	void RegisterReadyCallback(Callback_t *ready);
+	// after this the read, crit line and write callbacks are no longer called, instead the
+	// completions are saved in a queue with room for size records to start with and the
+	// host picks them all up at once with drainCompletions, once per cycle is plenty
+	// the records stay valid until the next call to drainCompletions
+	void RegisterCompletionQueue(uint64_t size);
+	uint64_t drainCompletions(const CompletionRecord **records);
 
 	void saveNVState(string filename);
 	void loadNVState(string filename);
     };
 
+    // runs the nvdimm on its own thread and only syncs with the host every quantum cycles
+    // requests and completions can be held up for up to a quantum
+    class ThreadedNVDIMM
+    {
+    public:
+	bool addTransaction(bool isWrite, uint64_t addr);
+	void update(void);
+	uint64_t drainCompletions(const CompletionRecord **records);
+	void printStats(void);
+	void saveStats(void);
+	void stop(void);
+    };
+
     NVDIMM *getNVDIMMInstance(uint64_t id, string deviceFile, string sysFile, string pwd, string trc);
+    // same as above but the given keys replace whatever the ini file set
+    NVDIMM *getNVDIMMInstance(uint64_t id, string deviceFile, string sysFile, string pwd, string trc, std::vector<string> overrideKeys, std::vector<string> overrideValues);
+    // ringSize is also the most requests the host can have waiting on the nvdimm
+    ThreadedNVDIMM *getThreadedNVDIMMInstance(NVDIMM *nv, uint64_t quantum, uint64_t ringSize);
+    // stops the nvdimm thread if stop hasn't already and frees it, the nvdimm it was running is left alone
+    // use this instead of delete, the class above is only the part of it the host gets to see
+    void destroyThreadedNVDIMMInstance(ThreadedNVDIMM *threaded);
 }
 
 #endif
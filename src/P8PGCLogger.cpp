@@ -42,6 +42,15 @@ P8PGCLogger::P8PGCLogger()
 	vpp_idle_energy = vector<double>(NUM_PACKAGES, 0.0); 
 	vpp_access_energy = vector<double>(NUM_PACKAGES, 0.0); 
 	vpp_erase_energy = vector<double>(NUM_PACKAGES, 0.0); 
+
+	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
+	{
+	    stringstream prefix;
+	    prefix << "package" << i << ".";
+	    stats.derived(prefix.str()+"vpp_idle_energy_mj", [this, i]() { return vpp_idle_energy[i] * VPP * 0.000000001; });
+	    stats.derived(prefix.str()+"vpp_access_energy_mj", [this, i]() { return vpp_access_energy[i] * VPP * 0.000000001; });
+	    stats.derived(prefix.str()+"vpp_erase_energy_mj", [this, i]() { return vpp_erase_energy[i] * VPP * 0.000000001; });
+	}
 }
 
 void P8PGCLogger::update()
@@ -89,14 +98,7 @@ void P8PGCLogger::access_stop(uint64_t addr, uint64_t paddr)
 	    this->write_latency(a.stop - a.start);
 	    if(WEAR_LEVEL_LOG)
 	    {
-		if(writes_per_address.count(a.pAddr) == 0)
-		{
-		    writes_per_address[a.pAddr] = 1;
-		}
-		else
-		{
-		    writes_per_address[a.pAddr]++;
-		}
+		this->wear_write(a.pAddr);
 	    }
 	}
 	else if (a.op == ERASE)
@@ -107,6 +109,10 @@ void P8PGCLogger::access_stop(uint64_t addr, uint64_t paddr)
 	    vpp_erase_energy[a.package] += (VPP_ERASE_I - VPP_STANDBY_I) * ERASE_TIME/2;
 	    this->erase();
 	    this->erase_latency(a.stop - a.start);
+	    if(WEAR_LEVEL_LOG)
+	    {
+		this->wear_erase(a.pAddr);
+	    }
 	}
 	else if (a.op == GC_READ)		
 	{
@@ -127,14 +133,7 @@ void P8PGCLogger::access_stop(uint64_t addr, uint64_t paddr)
 	    this->gcwrite_latency(a.stop - a.start);
 	    if(WEAR_LEVEL_LOG)
 	    {
-		if(writes_per_address.count(a.pAddr) == 0)
-		{
-		    writes_per_address[a.pAddr] = 1;
-		}
-		else
-		{
-		    writes_per_address[a.pAddr]++;
-		}
+		this->wear_write(a.pAddr);
 	    }
 	}
 	
@@ -262,11 +261,7 @@ void P8PGCLogger::save(uint64_t cycle, uint64_t epoch)
 	{
 	    savefile<<"\nWrite Frequency Data: \n";
 	    savefile<<"========================\n";
-	    unordered_map<uint64_t, uint64_t>::iterator it;
-	    for (it = writes_per_address.begin(); it != writes_per_address.end(); it++)
-	    {
-		savefile<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
-	    }
+	    this->write_wear(savefile);
 	}
 
 	savefile<<"\nPower Data: \n";
@@ -295,14 +290,13 @@ void P8PGCLogger::save(uint64_t cycle, uint64_t epoch)
 
 	savefile.close();
 
-	if(USE_EPOCHS && !RUNTIME_WRITE)
+	// epochs were already streamed out as they finished, just make sure they're on disk
+	if(epochfile.is_open())
 	{
-	    list<EpochEntry>::iterator it;
-	    for (it = epoch_queue.begin(); it != epoch_queue.end(); it++)
-	    {
-		write_epoch(&(*it));
-	    }
+	    epochfile.flush();
 	}
+
+	save_stats(cycle, epoch);
 }
 
 void P8PGCLogger::print(uint64_t cycle) {
@@ -409,8 +403,6 @@ void P8PGCLogger::save_epoch(uint64_t cycle, uint64_t epoch)
     this_epoch.ftl_queue_length = ftl_queue_length;
     this_epoch.gc_queue_length = gc_queue_length;
 
-    this_epoch.writes_per_address = writes_per_address;
-
     for(uint64_t i = 0; i < ctrl_queue_length.size(); i++)
     {
 	for(uint64_t j = 0; j < ctrl_queue_length[i].size(); j++)
@@ -473,42 +465,16 @@ void P8PGCLogger::save_epoch(uint64_t cycle, uint64_t epoch)
 	}
     }   
 
-    if(RUNTIME_WRITE)
-    {
-	write_epoch(&this_epoch);
-    }
-    else
-    {
-	epoch_queue.push_front(this_epoch);
-    }
+    write_epoch(&this_epoch);
 
     last_epoch = temp_epoch;
+
+    save_epoch_stats(cycle, epoch);
 }
 
 void P8PGCLogger::write_epoch(EpochEntry *e)
 {
-    	if(e->epoch == 0 && RUNTIME_WRITE)
-	{
-	    string command_str = "test -e "+LOG_DIR+" || mkdir "+LOG_DIR;
-	    const char * command = command_str.c_str();
-	    int sys_done = system(command);
-	    if (sys_done != 0)
-	    {
-		WARNING("Something might have gone wrong when nvdimm attempted to makes its log directory");
-	    }
-	    savefile.open(LOG_DIR+"NVDIMM_EPOCH.log", ios_base::out | ios_base::trunc);
-	    savefile<<"NVDIMM_EPOCH Log \n";
-	}
-	else
-	{
-	    savefile.open(LOG_DIR+"NVDIMM_EPOCH.log", ios_base::out | ios_base::app);
-	}
-
-	if (!savefile) 
-	{
-	    ERROR("Cannot open PowerStats.log");
-	    exit(-1); 
-	}
+	this->open_epoch_file();
 
 	// Power stuff
 	// Total power used
@@ -550,88 +516,84 @@ void P8PGCLogger::write_epoch(EpochEntry *e)
 	     }
 	}
 
-	savefile<<"\nData for Epoch: "<<e->epoch<<"\n";
-	savefile<<"===========================\n";
-	savefile<<"\nAccess Data: \n";
-	savefile<<"========================\n";
-	savefile<<"Cycles Simulated: "<<e->cycle<<"\n";
-	savefile<<"Accesses completed: "<<e->num_accesses<<"\n";
-	savefile<<"Reads completed: "<<e->num_reads<<"\n";
-	savefile<<"Writes completed: "<<e->num_writes<<"\n";
-	savefile<<"Erases completed: "<<e->num_erases<<"\n";
-	savefile<<"GC Reads completed: "<<e->num_gcreads<<"\n";
-	savefile<<"GC Writes completed: "<<e->num_gcwrites<<"\n";
-	savefile<<"Number of Unmapped Accesses: " <<e->num_unmapped<<"\n";
-	savefile<<"Number of Mapped Accesses: " <<e->num_mapped<<"\n";
-	savefile<<"Number of Unmapped Reads: " <<e->num_read_unmapped<<"\n";
-	savefile<<"Number of Mapped Reads: " <<e->num_read_mapped<<"\n";
-	savefile<<"Number of Unmapped Writes: " <<e->num_write_unmapped<<"\n";
-	savefile<<"Number of Mapped Writes: " <<e->num_write_mapped<<"\n";
-
-	savefile<<"\nThroughput and Latency Data: \n";
-	savefile<<"========================\n";
-	savefile<<"Average Read Latency: " <<(divide((float)e->average_read_latency,(float)e->num_reads))<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_read_latency,(float)e->num_reads)*CYCLE_TIME)<<" ns)\n";
-	savefile<<"Average Write Latency: " <<divide((float)e->average_write_latency,(float)e->num_writes)<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_write_latency,(float)e->num_writes))*CYCLE_TIME<<" ns)\n";	
-	savefile<<"Average Erase Latency: " <<divide((float)e->average_erase_latency,(float)e->num_erases)<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_erase_latency,(float)e->num_erases))*CYCLE_TIME<<" ns)\n";
-	savefile<<"Average Garbage Collector initiated Read Latency: " <<divide((float)e->average_gcread_latency,(float)e->num_gcreads)<<" cycles";
-	savefile<<" (" <<divide((float)e->average_gcread_latency,(float)e->num_gcreads)*CYCLE_TIME<<" ns)\n";
-        savefile<<"Average Garbage Collector initiated Write Latency: " <<divide((float)e->average_gcwrite_latency,(float)e->num_gcwrites)<<" cycles";
-	savefile<<" (" <<divide((float)e->average_gcwrite_latency,(float)e->num_gcwrites)*CYCLE_TIME<<" ns)\n";
-	savefile<<"Average Queue Latency: " <<divide((float)e->average_queue_latency,(float)e->num_accesses)<<" cycles";
-	savefile<<" (" <<(divide((float)e->average_queue_latency,(float)e->num_accesses))*CYCLE_TIME<<" ns)\n";
-	savefile<<"Total Throughput: " <<this->calc_throughput(e->cycle, e->num_accesses)<<" KB/sec\n";
-	savefile<<"Read Throughput: " <<this->calc_throughput(e->cycle, e->num_reads)<<" KB/sec\n";
-	savefile<<"Write Throughput: " <<this->calc_throughput(e->cycle, e->num_writes)<<" KB/sec\n";
-
-	savefile<<"\nQueue Length Data: \n";
-	savefile<<"========================\n";
-	savefile<<"Length of Ftl Queue: " <<e->ftl_queue_length<<"\n";
-	savefile<<"Length of GC Queue: " <<e->gc_queue_length<<"\n";
+	epochfile<<"\nData for Epoch: "<<e->epoch<<"\n";
+	epochfile<<"===========================\n";
+	epochfile<<"\nAccess Data: \n";
+	epochfile<<"========================\n";
+	epochfile<<"Cycles Simulated: "<<e->cycle<<"\n";
+	epochfile<<"Accesses completed: "<<e->num_accesses<<"\n";
+	epochfile<<"Reads completed: "<<e->num_reads<<"\n";
+	epochfile<<"Writes completed: "<<e->num_writes<<"\n";
+	epochfile<<"Erases completed: "<<e->num_erases<<"\n";
+	epochfile<<"GC Reads completed: "<<e->num_gcreads<<"\n";
+	epochfile<<"GC Writes completed: "<<e->num_gcwrites<<"\n";
+	epochfile<<"Number of Unmapped Accesses: " <<e->num_unmapped<<"\n";
+	epochfile<<"Number of Mapped Accesses: " <<e->num_mapped<<"\n";
+	epochfile<<"Number of Unmapped Reads: " <<e->num_read_unmapped<<"\n";
+	epochfile<<"Number of Mapped Reads: " <<e->num_read_mapped<<"\n";
+	epochfile<<"Number of Unmapped Writes: " <<e->num_write_unmapped<<"\n";
+	epochfile<<"Number of Mapped Writes: " <<e->num_write_mapped<<"\n";
+
+	epochfile<<"\nThroughput and Latency Data: \n";
+	epochfile<<"========================\n";
+	epochfile<<"Average Read Latency: " <<(divide((float)e->average_read_latency,(float)e->num_reads))<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_read_latency,(float)e->num_reads)*CYCLE_TIME)<<" ns)\n";
+	epochfile<<"Average Write Latency: " <<divide((float)e->average_write_latency,(float)e->num_writes)<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_write_latency,(float)e->num_writes))*CYCLE_TIME<<" ns)\n";	
+	epochfile<<"Average Erase Latency: " <<divide((float)e->average_erase_latency,(float)e->num_erases)<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_erase_latency,(float)e->num_erases))*CYCLE_TIME<<" ns)\n";
+	epochfile<<"Average Garbage Collector initiated Read Latency: " <<divide((float)e->average_gcread_latency,(float)e->num_gcreads)<<" cycles";
+	epochfile<<" (" <<divide((float)e->average_gcread_latency,(float)e->num_gcreads)*CYCLE_TIME<<" ns)\n";
+        epochfile<<"Average Garbage Collector initiated Write Latency: " <<divide((float)e->average_gcwrite_latency,(float)e->num_gcwrites)<<" cycles";
+	epochfile<<" (" <<divide((float)e->average_gcwrite_latency,(float)e->num_gcwrites)*CYCLE_TIME<<" ns)\n";
+	epochfile<<"Average Queue Latency: " <<divide((float)e->average_queue_latency,(float)e->num_accesses)<<" cycles";
+	epochfile<<" (" <<(divide((float)e->average_queue_latency,(float)e->num_accesses))*CYCLE_TIME<<" ns)\n";
+	epochfile<<"Total Throughput: " <<this->calc_throughput(e->cycle, e->num_accesses)<<" KB/sec\n";
+	epochfile<<"Read Throughput: " <<this->calc_throughput(e->cycle, e->num_reads)<<" KB/sec\n";
+	epochfile<<"Write Throughput: " <<this->calc_throughput(e->cycle, e->num_writes)<<" KB/sec\n";
+
+	epochfile<<"\nQueue Length Data: \n";
+	epochfile<<"========================\n";
+	epochfile<<"Length of Ftl Queue: " <<e->ftl_queue_length<<"\n";
+	epochfile<<"Length of GC Queue: " <<e->gc_queue_length<<"\n";
 	for(uint64_t i = 0; i < e->ctrl_queue_length.size(); i++)
 	{
 	    for(uint64_t j = 0; j < e->ctrl_queue_length[i].size(); j++)
 	    {
-		savefile<<"Length of Controller Queue for Package " << i << ", Die " << j << ": "<<e->ctrl_queue_length[i][j]<<"\n";
+		epochfile<<"Length of Controller Queue for Package " << i << ", Die " << j << ": "<<e->ctrl_queue_length[i][j]<<"\n";
 	    }
 	}
 	
 	if(WEAR_LEVEL_LOG)
 	{
-	    savefile<<"\nWrite Frequency Data: \n";
-	    savefile<<"========================\n";
-	    unordered_map<uint64_t, uint64_t>::iterator it;
-	    for (it = e->writes_per_address.begin(); it != e->writes_per_address.end(); it++)
-	    {
-		savefile<<"Address "<<(*it).first<<": "<<(*it).second<<" writes\n";
-	    }
+	    epochfile<<"\nWrite Frequency Data: \n";
+	    epochfile<<"========================\n";
+	    this->write_epoch_wear();
 	}
 
-	savefile<<"\nPower Data: \n";
-	savefile<<"========================\n";
+	epochfile<<"\nPower Data: \n";
+	epochfile<<"========================\n";
 	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
 	{
-	    savefile<<"Package: "<<i<<"\n";
-	    savefile<<"Accumulated Idle Energy: "<<(e->idle_energy[i] * VCC * 0.000000001)<<" mJ\n";
-	    savefile<<"Accumulated Access Energy: "<<(e->access_energy[i] * VCC * 0.000000001)<<" mJ\n";
-	    savefile<<"Accumulated Erase Energy: "<<(e->erase_energy[i] * VCC * 0.000000001)<<" mJ\n";
-	    savefile<<"Accumulated VPP Idle Energy: "<<(e->vpp_idle_energy[i] * VPP * 0.000000001)<<" mJ\n";
-	    savefile<<"Accumulated VPP Access Energy: "<<(e->vpp_access_energy[i] * VPP * 0.000000001)<<" mJ\n";		 
-	    savefile<<"Accumulated VPP Erase Energy: "<<(e->vpp_erase_energy[i] * VPP * 0.000000001)<<" mJ\n";
-	    savefile<<"Total Energy: "<<(total_energy[i] * 0.000000001)<<" mJ\n\n";
+	    epochfile<<"Package: "<<i<<"\n";
+	    epochfile<<"Accumulated Idle Energy: "<<(e->idle_energy[i] * VCC * 0.000000001)<<" mJ\n";
+	    epochfile<<"Accumulated Access Energy: "<<(e->access_energy[i] * VCC * 0.000000001)<<" mJ\n";
+	    epochfile<<"Accumulated Erase Energy: "<<(e->erase_energy[i] * VCC * 0.000000001)<<" mJ\n";
+	    epochfile<<"Accumulated VPP Idle Energy: "<<(e->vpp_idle_energy[i] * VPP * 0.000000001)<<" mJ\n";
+	    epochfile<<"Accumulated VPP Access Energy: "<<(e->vpp_access_energy[i] * VPP * 0.000000001)<<" mJ\n";		 
+	    epochfile<<"Accumulated VPP Erase Energy: "<<(e->vpp_erase_energy[i] * VPP * 0.000000001)<<" mJ\n";
+	    epochfile<<"Total Energy: "<<(total_energy[i] * 0.000000001)<<" mJ\n\n";
 	 
-	    savefile<<"Average Idle Power: "<<ave_idle_power[i]<<" mW\n";
-	    savefile<<"Average Access Power: "<<ave_access_power[i]<<" mW\n";
-	    savefile<<"Average Erase Power: "<<ave_erase_power[i]<<" mW\n";
-	    savefile<<"Average VPP Idle Power: "<<ave_vpp_idle_power[i]<<" mW\n";
-	    savefile<<"Average VPP Access Power: "<<ave_vpp_access_power[i]<<" mW\n";
-	    savefile<<"Average VPP Erase Power: "<<ave_vpp_erase_power[i]<<" mW\n";
-	    savefile<<"Average Power: "<<average_power[i]<<" mW\n\n";
+	    epochfile<<"Average Idle Power: "<<ave_idle_power[i]<<" mW\n";
+	    epochfile<<"Average Access Power: "<<ave_access_power[i]<<" mW\n";
+	    epochfile<<"Average Erase Power: "<<ave_erase_power[i]<<" mW\n";
+	    epochfile<<"Average VPP Idle Power: "<<ave_vpp_idle_power[i]<<" mW\n";
+	    epochfile<<"Average VPP Access Power: "<<ave_vpp_access_power[i]<<" mW\n";
+	    epochfile<<"Average VPP Erase Power: "<<ave_vpp_erase_power[i]<<" mW\n";
+	    epochfile<<"Average Power: "<<average_power[i]<<" mW\n\n";
 	}
 
-	savefile<<"\n-------------------------------------------------\n";
+	epochfile<<"\n-------------------------------------------------\n";
 
-	savefile.close();
+	this->close_epoch_entry();
 }
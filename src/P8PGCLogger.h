@@ -101,8 +101,6 @@ namespace NVDSim
 	    uint64_t gc_queue_length;
 	    std::vector<std::vector <uint64_t> > ctrl_queue_length;
 
-	    std::unordered_map<uint64_t, uint64_t> writes_per_address;
-
 	    std::vector<double> idle_energy;
 	    std::vector<double> access_energy;
 	    std::vector<double> erase_energy;
@@ -153,9 +151,6 @@ namespace NVDSim
 	// Store system snapshot from last epoch to compute this epoch
 	EpochEntry last_epoch;
 	       
-	// Store the data from each epoch for printing at the end of the simulation
-	std::list<EpochEntry> epoch_queue;
-
 	using GCLogger::write_epoch; // This is to make Clang happy since GCLogger::EpochEntry is different from P8PGCLogger::EpochEntry.
 	virtual void write_epoch(EpochEntry *e);
     };
@@ -43,6 +43,7 @@ using namespace std;
 Plane::Plane(void){
 	dataReg= NULL;
 	cacheReg= NULL;
+	suspendedReg= NULL;
 }
 
 void Plane::read(ChannelPacket *busPacket){
@@ -144,3 +145,20 @@ void Plane::dataGone(void)
     // read no longer needs this register
     cacheReg = NULL;
 }
+
+void Plane::suspend(void)
+{
+    suspendedReg = dataReg;
+    dataReg = NULL;
+}
+
+void Plane::resume(void)
+{
+    if(dataReg != NULL)
+    {
+	ERROR("tried to resume plane but its data register is still in use");
+	abort();
+    }
+    dataReg = suspendedReg;
+    suspendedReg = NULL;
+}
@@ -53,8 +53,11 @@ namespace NVDSim{
 			bool checkCacheReg(void);
 			void dataUsed(void);
 			void dataGone(void);
+			void suspend(void);
+			void resume(void);
 		private:
 			ChannelPacket *dataReg, *cacheReg;
+			ChannelPacket *suspendedReg; // data reg of a suspended program, the read that suspended it needs the data reg
 			std::unordered_map<uint64_t, Block> blocks;
 	};
 }
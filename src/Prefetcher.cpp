@@ -0,0 +1,189 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//Prefetcher.cpp
+//Sequential stream detection and read ahead into the read cache
+
+#include "Prefetcher.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+Prefetcher::Prefetcher(NVDIMM *parent, Logger *l)
+{
+	parentNVDIMM = parent;
+	log = l;
+	cache_pages = READ_CACHE_SIZE / NV_PAGE_SIZE;
+
+	Stream s;
+	s.next = 0;
+	s.ahead = 0;
+	s.run = 0;
+	s.last_access = 0;
+	streams = vector<Stream>(PREFETCH_STREAMS, s);
+
+	currentClockCycle = 0;
+}
+
+void Prefetcher::access(uint64_t page, bool hit)
+{
+	uint64_t p = page / NV_PAGE_SIZE;
+
+	unordered_map<uint64_t, list<uint64_t>::iterator>::iterator u = unused.find(page);
+	if (u != unused.end())
+	{
+		// if it missed the cache threw the page out before the host got to it
+		if (hit && LOGGING)
+		{
+			log->prefetch_used();
+		}
+		unused_order.erase(u->second);
+		unused.erase(u);
+	}
+	else if (in_flight.erase(page) && LOGGING)
+	{
+		// right page but it didn't get here in time, the host's read goes to the flash too
+		log->prefetch_late();
+	}
+	pending.remove(page);
+
+	// the read either moves a stream along or starts a new one
+	uint64_t lru = 0;
+	for (uint64_t i = 0; i < streams.size(); i++)
+	{
+		Stream &s = streams[i];
+		if (s.run > 0 && p >= s.next && p <= max(s.next, s.ahead))
+		{
+			s.run++;
+			s.next = p + 1;
+			s.last_access = currentClockCycle;
+			fetchAhead(s);
+			return;
+		}
+		// streams that have never been used go first
+		if (streams[lru].run != 0 && (s.run == 0 || s.last_access < streams[lru].last_access))
+		{
+			lru = i;
+		}
+	}
+
+	Stream &s = streams[lru];
+	s.next = p + 1;
+	s.ahead = p;
+	s.run = 1;
+	s.last_access = currentClockCycle;
+	fetchAhead(s);
+}
+
+void Prefetcher::fetchAhead(Stream &s)
+{
+	if (s.run < PREFETCH_TRIGGER)
+	{
+		return;
+	}
+
+	// nothing past the end of the host's space, with DFTL that's where the mapping table lives
+	uint64_t target = s.next - 1 + PREFETCH_DEPTH;
+	for (uint64_t p = max(s.ahead, s.next - 1) + 1; p <= target && p < VIRTUAL_TOTAL_SIZE * 1024 / NV_PAGE_SIZE; p++)
+	{
+		pending.push_back(p * NV_PAGE_SIZE);
+	}
+	s.ahead = max(s.ahead, target);
+
+	// the oldest ones are the least likely to still be wanted
+	while (pending.size() > PREFETCH_DEPTH * PREFETCH_STREAMS)
+	{
+		pending.pop_front();
+	}
+}
+
+void Prefetcher::filled(uint64_t page)
+{
+	// the host already asked for it while it was on its way
+	if (!in_flight.erase(page))
+	{
+		return;
+	}
+
+	if (unused.find(page) == unused.end())
+	{
+		unused_order.push_back(page);
+		unused[page] = --unused_order.end();
+	}
+	while (unused_order.size() > cache_pages)
+	{
+		unused.erase(unused_order.front());
+		unused_order.pop_front();
+	}
+}
+
+void Prefetcher::update(void)
+{
+	while (!pending.empty())
+	{
+		uint64_t page = pending.front();
+		Ftl *ftl = parentNVDIMM->ftlFor(page);
+
+		// nothing to gain from these, and a page that is sitting in the write buffer is newer than what's on the flash
+		if (page >= VIRTUAL_TOTAL_SIZE * 1024 || in_flight.count(page) || parentNVDIMM->readCache->contains(page, NV_PAGE_SIZE) || !ftl->isMapped(page) ||
+		    (WRITE_BUFFER && parentNVDIMM->writeBuffer->holds(page)))
+		{
+			pending.pop_front();
+			continue;
+		}
+
+		// an unbounded read queue is treated as if it could hold a full prefetch
+		uint64_t queue_length = FTL_READ_QUEUE_LENGTH != 0 ? FTL_READ_QUEUE_LENGTH : PREFETCH_DEPTH;
+		if (ftl->readQueueSize() >= PREFETCH_QUEUE_OCCUPANCY * queue_length)
+		{
+			break;
+		}
+
+		FlashTransaction prefetch = FlashTransaction(DATA_READ, page, NULL);
+		prefetch.origin = PREFETCH_ORIGIN;
+		prefetch.cache_generation = parentNVDIMM->readCache->generation();
+		if (!ftl->addTransaction(prefetch))
+		{
+			break;
+		}
+		in_flight.insert(page);
+		pending.pop_front();
+		if (LOGGING)
+		{
+			log->prefetch_issued();
+		}
+	}
+
+	step();
+}
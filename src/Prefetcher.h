@@ -0,0 +1,101 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVPREFETCHER_H
+#define NVPREFETCHER_H
+
+//Prefetcher.h
+//Sequential stream detection and read ahead into the read cache, see PREFETCH
+//
+//Every host read that gets as far as the read cache is checked against the
+//streams we are tracking. A read of the page right after a stream's last one
+//(or of any page we already fetched ahead for it) moves the stream along,
+//anything else starts a new stream in place of the least recently used one.
+//Once a stream has read PREFETCH_TRIGGER pages in a row we keep the next
+//PREFETCH_DEPTH pages on their way into the read cache. Prefetches sit at the
+//back of the line, they only go to the ftl while its read queue is less than
+//PREFETCH_QUEUE_OCCUPANCY full so they never crowd out the host's reads.
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdint.h>
+
+#include "SimObj.h"
+#include "FlashConfiguration.h"
+#include "FlashTransaction.h"
+#include "Logger.h"
+
+namespace NVDSim
+{
+	class NVDIMM;
+	class Prefetcher : public SimObj
+	{
+	public:
+		Prefetcher(NVDIMM *parent, Logger *l);
+
+		// a host read of this page was just looked up in the read cache
+		void access(uint64_t page, bool hit);
+		// a prefetch came back and the page is in the read cache now
+		void filled(uint64_t page);
+
+		void update(void);
+
+	private:
+		class Stream
+		{
+		public:
+			uint64_t next; // page number we expect the stream to read next
+			uint64_t ahead; // last page number we have fetched or queued for it
+			uint64_t run; // pages read in a row
+			uint64_t last_access;
+		};
+
+		void fetchAhead(Stream &s);
+
+		NVDIMM *parentNVDIMM;
+		Logger *log;
+
+		std::vector<Stream> streams;
+		std::list<uint64_t> pending; // pages waiting for room in the ftl, oldest first
+		std::unordered_set<uint64_t> in_flight;
+		// pages we brought into the cache that the host hasn't read yet, the oldest ones are forgotten
+		// once there are more of them than the cache could hold
+		std::list<uint64_t> unused_order;
+		std::unordered_map<uint64_t, std::list<uint64_t>::iterator> unused;
+		uint64_t cache_pages;
+	};
+}
+
+#endif
@@ -0,0 +1,388 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//ReadCache.cpp
+//DRAM page cache on the controller in front of the ftl
+
+#include <algorithm>
+
+#include "ReadCache.h"
+
+using namespace NVDSim;
+using namespace std;
+
+ReadCache::ReadCache(Logger *l)
+{
+	log = l;
+	invalidations = 0;
+
+	// NVDIMM already checked that it is one of these
+	if (READ_CACHE_POLICY.compare("ARC") == 0)
+	{
+		policy = CACHE_ARC;
+	}
+	else if (READ_CACHE_POLICY.compare("CLOCK") == 0)
+	{
+		policy = CACHE_CLOCK;
+	}
+	else
+	{
+		policy = CACHE_LRU;
+	}
+
+	uint64_t lines = READ_CACHE_SIZE / READ_CACHE_LINE_SIZE;
+	uint64_t ways = (READ_CACHE_WAYS == 0) ? lines : READ_CACHE_WAYS;
+	for (uint64_t i = 0; i < lines / ways; i++)
+	{
+		switch (policy)
+		{
+		case CACHE_ARC:
+			sets.push_back(new ArcSet(ways));
+			break;
+		case CACHE_CLOCK:
+			sets.push_back(new ClockSet(ways));
+			break;
+		case CACHE_LRU:
+			sets.push_back(new LruSet(ways));
+			break;
+		}
+	}
+}
+
+ReadCache::~ReadCache(void)
+{
+	for (uint64_t i = 0; i < sets.size(); i++)
+	{
+		delete sets[i];
+	}
+}
+
+// consecutive lines go to consecutive sets so a sequential run spreads over all of them
+ReadCache::CacheSet *ReadCache::setFor(uint64_t line)
+{
+	return sets[line % sets.size()];
+}
+
+bool ReadCache::lookup(uint64_t addr, uint64_t size)
+{
+	uint64_t first = addr / READ_CACHE_LINE_SIZE;
+	uint64_t last = (addr + size - 1) / READ_CACHE_LINE_SIZE;
+	for (uint64_t line = first; line <= last; line++)
+	{
+		if (!setFor(line)->lookup(line))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ReadCache::contains(uint64_t addr, uint64_t size)
+{
+	uint64_t first = addr / READ_CACHE_LINE_SIZE;
+	uint64_t last = (addr + size - 1) / READ_CACHE_LINE_SIZE;
+	for (uint64_t line = first; line <= last; line++)
+	{
+		if (!setFor(line)->contains(line))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ReadCache::fill(uint64_t addr, uint64_t size)
+{
+	uint64_t first = addr / READ_CACHE_LINE_SIZE;
+	uint64_t last = (addr + size - 1) / READ_CACHE_LINE_SIZE;
+	for (uint64_t line = first; line <= last; line++)
+	{
+		CacheSet *set = setFor(line);
+		if (!set->contains(line) && set->fill(line) && LOGGING)
+		{
+			log->read_cache_evicted();
+		}
+	}
+}
+
+void ReadCache::invalidate(uint64_t addr, uint64_t size)
+{
+	uint64_t first = addr / READ_CACHE_LINE_SIZE;
+	uint64_t last = (addr + size - 1) / READ_CACHE_LINE_SIZE;
+	for (uint64_t line = first; line <= last; line++)
+	{
+		setFor(line)->invalidate(line);
+	}
+
+	invalidations++;
+	for (uint64_t page = addr / NV_PAGE_SIZE; page <= (addr + size - 1) / NV_PAGE_SIZE; page++)
+	{
+		last_invalidated[page] = invalidations;
+	}
+}
+
+uint64_t ReadCache::generation(void)
+{
+	return invalidations;
+}
+
+bool ReadCache::invalidatedSince(uint64_t addr, uint64_t g)
+{
+	unordered_map<uint64_t, uint64_t>::iterator it = last_invalidated.find(addr / NV_PAGE_SIZE);
+	return it != last_invalidated.end() && it->second > g;
+}
+
+bool ReadCache::LruSet::lookup(uint64_t line)
+{
+	unordered_map<uint64_t, list<uint64_t>::iterator>::iterator it = where.find(line);
+	if (it == where.end())
+	{
+		return false;
+	}
+	lines.splice(lines.begin(), lines, it->second);
+	return true;
+}
+
+bool ReadCache::LruSet::contains(uint64_t line)
+{
+	return where.count(line) != 0;
+}
+
+bool ReadCache::LruSet::fill(uint64_t line)
+{
+	bool evicted = false;
+	if (lines.size() >= ways)
+	{
+		where.erase(lines.back());
+		lines.pop_back();
+		evicted = true;
+	}
+	lines.push_front(line);
+	where[line] = lines.begin();
+	return evicted;
+}
+
+void ReadCache::LruSet::invalidate(uint64_t line)
+{
+	unordered_map<uint64_t, list<uint64_t>::iterator>::iterator it = where.find(line);
+	if (it != where.end())
+	{
+		lines.erase(it->second);
+		where.erase(it);
+	}
+}
+
+ReadCache::ClockSet::ClockSet(uint64_t w) : CacheSet(w)
+{
+	Frame empty = {0, false, false};
+	frames = vector<Frame>(w, empty);
+	hand = 0;
+}
+
+bool ReadCache::ClockSet::lookup(uint64_t line)
+{
+	unordered_map<uint64_t, uint64_t>::iterator it = where.find(line);
+	if (it == where.end())
+	{
+		return false;
+	}
+	frames[it->second].referenced = true;
+	return true;
+}
+
+bool ReadCache::ClockSet::contains(uint64_t line)
+{
+	return where.count(line) != 0;
+}
+
+// sweep the hand along clearing reference bits until it lands on a frame that is free or wasn't used since the last sweep
+bool ReadCache::ClockSet::fill(uint64_t line)
+{
+	while (frames[hand].valid && frames[hand].referenced)
+	{
+		frames[hand].referenced = false;
+		hand = (hand + 1) % ways;
+	}
+
+	bool evicted = frames[hand].valid;
+	if (evicted)
+	{
+		where.erase(frames[hand].line);
+	}
+	frames[hand].line = line;
+	frames[hand].valid = true;
+	frames[hand].referenced = true;
+	where[line] = hand;
+	hand = (hand + 1) % ways;
+	return evicted;
+}
+
+void ReadCache::ClockSet::invalidate(uint64_t line)
+{
+	unordered_map<uint64_t, uint64_t>::iterator it = where.find(line);
+	if (it != where.end())
+	{
+		frames[it->second].valid = false;
+		frames[it->second].referenced = false;
+		where.erase(it);
+	}
+}
+
+list<uint64_t> &ReadCache::ArcSet::get(ArcList l)
+{
+	switch (l)
+	{
+	case T1:
+		return t1;
+	case T2:
+		return t2;
+	case B1:
+		return b1;
+	default:
+		return b2;
+	}
+}
+
+// puts the line at the front of the list, taking it out of whatever list it was in first
+void ReadCache::ArcSet::move(uint64_t line, ArcList to)
+{
+	unordered_map<uint64_t, Entry>::iterator it = where.find(line);
+	if (it != where.end())
+	{
+		get(it->second.list).erase(it->second.it);
+	}
+	get(to).push_front(line);
+	Entry e = {to, get(to).begin()};
+	where[line] = e;
+}
+
+void ReadCache::ArcSet::drop(list<uint64_t> &from)
+{
+	where.erase(from.back());
+	from.pop_back();
+}
+
+// evicts from t1 if it is over its target size and from t2 otherwise, evicted lines are remembered in the ghost lists
+bool ReadCache::ArcSet::replace(bool inB2)
+{
+	// invalidations can leave room, in which case there is nothing to do
+	if (t1.size() + t2.size() < ways)
+	{
+		return false;
+	}
+	if (!t1.empty() && (t2.empty() || t1.size() > p || (inB2 && t1.size() == p)))
+	{
+		move(t1.back(), B1);
+	}
+	else
+	{
+		move(t2.back(), B2);
+	}
+	return true;
+}
+
+bool ReadCache::ArcSet::lookup(uint64_t line)
+{
+	unordered_map<uint64_t, Entry>::iterator it = where.find(line);
+	if (it == where.end() || it->second.list == B1 || it->second.list == B2)
+	{
+		return false;
+	}
+	move(line, T2);
+	return true;
+}
+
+bool ReadCache::ArcSet::contains(uint64_t line)
+{
+	unordered_map<uint64_t, Entry>::iterator it = where.find(line);
+	return it != where.end() && (it->second.list == T1 || it->second.list == T2);
+}
+
+bool ReadCache::ArcSet::fill(uint64_t line)
+{
+	bool evicted = false;
+	unordered_map<uint64_t, Entry>::iterator it = where.find(line);
+
+	// recently evicted from t1, so t1 should have been bigger
+	if (it != where.end() && it->second.list == B1)
+	{
+		p = min(ways, p + max(b2.size() / b1.size(), (size_t)1));
+		evicted = replace(false);
+		move(line, T2);
+	}
+	// recently evicted from t2, so t2 should have been bigger
+	else if (it != where.end() && it->second.list == B2)
+	{
+		uint64_t delta = max(b1.size() / b2.size(), (size_t)1);
+		p = (p > delta) ? p - delta : 0;
+		evicted = replace(true);
+		move(line, T2);
+	}
+	// never seen it, keep t1 and b1 to one cache's worth and everything to two
+	else
+	{
+		if (t1.size() + b1.size() >= ways)
+		{
+			if (t1.size() < ways)
+			{
+				drop(b1);
+				evicted = replace(false);
+			}
+			else
+			{
+				drop(t1);
+				evicted = true;
+			}
+		}
+		else if (t1.size() + t2.size() + b1.size() + b2.size() >= ways)
+		{
+			if (t1.size() + t2.size() + b1.size() + b2.size() >= 2 * ways)
+			{
+				drop(b2);
+			}
+			evicted = replace(false);
+		}
+		move(line, T1);
+	}
+	return evicted;
+}
+
+void ReadCache::ArcSet::invalidate(uint64_t line)
+{
+	unordered_map<uint64_t, Entry>::iterator it = where.find(line);
+	if (it != where.end() && (it->second.list == T1 || it->second.list == T2))
+	{
+		get(it->second.list).erase(it->second.it);
+		where.erase(it);
+	}
+}
@@ -0,0 +1,174 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVREADCACHE_H
+#define NVREADCACHE_H
+
+//ReadCache.h
+//DRAM page cache on the controller in front of the ftl, see READ_CACHE
+//
+//Only the tags are kept, the cache never holds real data. Reads that hit come
+//back after READ_CACHE_HIT_LATENCY without going to the ftl, reads that miss
+//are filled in when their data comes back and writes throw away whatever they
+//overwrite. Each set does its own replacement so ARC and CLOCK are per set,
+//with READ_CACHE_WAYS of 0 there is only one set and they work over the whole
+//cache.
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "FlashConfiguration.h"
+#include "Logger.h"
+
+namespace NVDSim
+{
+	enum CachePolicy
+	{
+		CACHE_LRU,
+		CACHE_ARC,
+		CACHE_CLOCK
+	};
+
+	class ReadCache
+	{
+	public:
+		ReadCache(Logger *l);
+		~ReadCache(void);
+
+		// true if every line from addr to addr+size is in the cache, counts as a use of them if it is
+		bool lookup(uint64_t addr, uint64_t size);
+		// like lookup but doesn't count as a use
+		bool contains(uint64_t addr, uint64_t size);
+		// brings in every line from addr to addr+size that isn't already there
+		void fill(uint64_t addr, uint64_t size);
+		void invalidate(uint64_t addr, uint64_t size);
+		// goes up with every invalidate, a read remembers it when it is sent
+		uint64_t generation(void);
+		// true if the page addr is in was invalidated after generation g, so a read sent then brought back old data
+		bool invalidatedSince(uint64_t addr, uint64_t g);
+
+	private:
+		// the replacement policies only ever see line numbers
+		class CacheSet
+		{
+		public:
+			CacheSet(uint64_t w) : ways(w) {}
+			virtual ~CacheSet() {}
+			virtual bool lookup(uint64_t line) = 0;
+			// like lookup but doesn't count as a use
+			virtual bool contains(uint64_t line) = 0;
+			// only called for lines that aren't in the set, returns true if something had to go to make room
+			virtual bool fill(uint64_t line) = 0;
+			virtual void invalidate(uint64_t line) = 0;
+		protected:
+			uint64_t ways;
+		};
+
+		class LruSet : public CacheSet
+		{
+		public:
+			LruSet(uint64_t w) : CacheSet(w) {}
+			bool lookup(uint64_t line);
+			bool contains(uint64_t line);
+			bool fill(uint64_t line);
+			void invalidate(uint64_t line);
+		private:
+			std::list<uint64_t> lines; // most recently used at the front
+			std::unordered_map<uint64_t, std::list<uint64_t>::iterator> where;
+		};
+
+		class ClockSet : public CacheSet
+		{
+		public:
+			ClockSet(uint64_t w);
+			bool lookup(uint64_t line);
+			bool contains(uint64_t line);
+			bool fill(uint64_t line);
+			void invalidate(uint64_t line);
+		private:
+			class Frame
+			{
+			public:
+				uint64_t line;
+				bool valid;
+				bool referenced;
+			};
+			std::vector<Frame> frames;
+			uint64_t hand;
+			std::unordered_map<uint64_t, uint64_t> where;
+		};
+
+		// Megiddo and Modha's adaptive replacement cache
+		// t1 has the lines seen once recently, t2 the ones seen more than once, b1 and b2 remember
+		// what was recently evicted from each and move p, the target size of t1, towards whichever is missing more
+		class ArcSet : public CacheSet
+		{
+		public:
+			ArcSet(uint64_t w) : CacheSet(w), p(0) {}
+			bool lookup(uint64_t line);
+			bool contains(uint64_t line);
+			bool fill(uint64_t line);
+			void invalidate(uint64_t line);
+		private:
+			enum ArcList { T1, T2, B1, B2 };
+			class Entry
+			{
+			public:
+				ArcList list;
+				std::list<uint64_t>::iterator it;
+			};
+			bool replace(bool inB2);
+			void move(uint64_t line, ArcList to);
+			void drop(std::list<uint64_t> &from);
+			std::list<uint64_t> &get(ArcList l);
+
+			std::list<uint64_t> t1, t2, b1, b2; // most recent at the front
+			std::unordered_map<uint64_t, Entry> where;
+			uint64_t p;
+		};
+
+		CacheSet *setFor(uint64_t line);
+
+		Logger *log;
+
+		CachePolicy policy;
+		std::vector<CacheSet *> sets;
+
+		uint64_t invalidations;
+		std::unordered_map<uint64_t, uint64_t> last_invalidated; // page to the generation it was last invalidated in
+	};
+}
+
+#endif
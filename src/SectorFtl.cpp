@@ -0,0 +1,429 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//SectorFtl.cpp
+//class file for the sector mapped gc ftl
+//
+#include "SectorFtl.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+SectorFtl::SectorFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s) 
+    : GCFtl(c, l, p, s)
+{
+	int numBlocks = NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE * BLOCKS_PER_PLANE;
+
+	sectors_per_page = NV_PAGE_SIZE / HOST_SECTOR_SIZE;
+
+	open_pack = NULL;
+	gc_pack = NULL;
+
+	invalid_sectors = vector<uint64_t>(numBlocks, 0);
+	invalid_sector_count = 0;
+}
+
+bool SectorFtl::addTransaction(FlashTransaction &t){
+    if(t.address >= (VIRTUAL_TOTAL_SIZE*1024))
+    {
+	// let the gc ftl complain about it
+	return GCFtl::addTransaction(t);
+    }
+
+    if(t.transactionType == DATA_WRITE)
+    {
+	// a sector that is written again while it is still waiting for the rest of its page just replaces the old data
+	if(open_pack != NULL)
+	{
+	    for(uint64_t i = 0; i < open_pack->writes.size(); i++)
+	    {
+		if(open_pack->writes[i].address == t.address)
+		{
+		    parent->writeDone(open_pack->writes[i], currentClockCycle);
+		    open_pack->writes[i] = t;
+		    if(LOGGING)
+		    {
+			log->sector_write(true);
+		    }
+		    return true;
+		}
+	    }
+	}
+
+	// the last page still hasn't made it into the queue, the host has to wait for it
+	if(!sealed.empty())
+	{
+	    return false;
+	}
+
+	if(open_pack == NULL)
+	{
+	    open_pack = new SectorPack();
+	    open_pack->first_write = currentClockCycle;
+	    open_pack->gc = false;
+	}
+	open_pack->writes.push_back(t);
+	buffered[t.address]++;
+	if(LOGGING)
+	{
+	    log->sector_write(false);
+	}
+
+	if(open_pack->writes.size() == sectors_per_page)
+	{
+	    sealed.push_back(open_pack);
+	    open_pack = NULL;
+	    queuePacks();
+	}
+	return true;
+    }
+    else if(t.transactionType == DATA_READ && buffered.find(t.address) != buffered.end())
+    {
+	// the data hasn't gone anywhere yet so the read is answered out of the pack, like a read out of the write queue
+	if(LOGGING)
+	{
+	    log->access_start(t.address, t.transactionType);
+	}
+	buffered_reads.push_back(make_pair(currentClockCycle + QUEUE_ACCESS_CYCLES, t));
+	return true;
+    }
+
+    return GCFtl::addTransaction(t);
+}
+
+void SectorFtl::update(void){
+    // don't hold a partly packed page back forever waiting for more sectors
+    if(open_pack != NULL && currentClockCycle - open_pack->first_write >= SECTOR_PACK_TIME)
+    {
+	sealed.push_back(open_pack);
+	open_pack = NULL;
+    }
+    queuePacks();
+
+    while(!buffered_reads.empty() && buffered_reads.front().first <= currentClockCycle)
+    {
+	FlashTransaction ret = buffered_reads.front().second;
+	if(LOGGING)
+	{
+	    log->read_mapped();
+	    log->access_process(ret.address, ret.address, 0, READ);
+	    log->access_stop(ret.address, ret.address);
+	}
+	ret.transactionType = RETURN_DATA;
+	controller->returnReadData(ret);
+	buffered_reads.pop_front();
+    }
+
+    GCFtl::update();
+}
+
+// the write that programs a pack, it goes through the ftl like any other write
+FlashTransaction SectorFtl::packTransaction(SectorPack *pack)
+{
+    FlashTransaction t = FlashTransaction(pack->gc ? GC_DATA_WRITE : DATA_WRITE, pack->writes.front().address, pack);
+    t.origin = SECTOR_PACK_ORIGIN;
+    t.timeAdded = pack->writes.front().timeAdded;
+    t.tenant = pack->writes.front().tenant;
+    // the page is as urgent as the most urgent sector in it
+    for(uint64_t i = 0; i < pack->writes.size(); i++)
+    {
+	if(pack->writes[i].deadline != 0 && (t.deadline == 0 || pack->writes[i].deadline < t.deadline))
+	{
+	    t.deadline = pack->writes[i].deadline;
+	}
+    }
+    return t;
+}
+
+void SectorFtl::queuePacks(void)
+{
+    bool added = false;
+    if(sealed.empty())
+    {
+	return;
+    }
+    while(!sealed.empty())
+    {
+	FlashTransaction t = packTransaction(sealed.front());
+	if(SCHEDULE || PERFECT_SCHEDULE)
+	{
+	    added = attemptAdd(t, &writeQueue, FTL_WRITE_QUEUE_LENGTH);
+	}
+	else
+	{
+	    added = attemptAdd(t, &readQueue, FTL_READ_QUEUE_LENGTH);
+	}
+	if(!added)
+	{
+	    return;
+	}
+	sealed.pop_front();
+    }
+    // the host may have been turned away while a page was stuck here
+    hostQueuePopped();
+}
+
+void SectorFtl::queueGcPack(void)
+{
+    FlashTransaction t = packTransaction(gc_pack);
+    addGcTransaction(t);
+    gc_pack = NULL;
+}
+
+void SectorFtl::write_used_handler(uint64_t vAddr)
+{
+    // the sectors of a pack are invalidated in write_success once the pack actually has a page
+}
+
+void SectorFtl::write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped)
+{
+    SectorPack *pack = (SectorPack *)currentTransaction.data;
+    uint64_t valid = 0;
+
+    used[block][page] = true;
+    used_page_count++;
+
+    // the gc ftl would pop the wrong queue for a gc write here so say which one it is
+    popFront(gc ? GC_WRITE : WRITE);
+    busy = 0;
+    write_counter++;
+
+    if (LOGGING && !gc)
+    {
+	if (mapped)
+	    log->write_mapped();
+	else
+	    log->write_unmapped();
+    }
+
+    for(uint64_t s = 0; s < pack->writes.size(); s++)
+    {
+	uint64_t sector = pack->writes[s].address;
+	if(!gc && --buffered[sector] == 0)
+	{
+	    buffered.erase(sector);
+	}
+	// a gc move only counts if nothing newer was written to the sector while it was on its way
+	if(gc && (addressMap.find(sector) == addressMap.end() || addressMap[sector] != pack->moved_from[s]))
+	{
+	    continue;
+	}
+	if(addressMap.find(sector) != addressMap.end())
+	{
+	    invalidate(addressMap[sector]);
+	}
+	addressMap[sector] = pAddr + s * HOST_SECTOR_SIZE;
+	reverseMap[pAddr + s * HOST_SECTOR_SIZE] = sector;
+	valid++;
+    }
+
+    // whatever of the page didn't get anything valid is garbage from the start
+    invalid_sectors[block] += sectors_per_page - valid;
+    invalid_sector_count += sectors_per_page - valid;
+    if(valid == 0)
+    {
+	dirty[block][page] = true;
+	dirty_page_count++;
+    }
+    else
+    {
+	page_valid[pAddr] = valid;
+    }
+
+    if(LOGGING)
+    {
+	log->sector_program(gc, valid);
+    }
+
+    if(gc)
+    {
+	delete pack;
+    }
+    else
+    {
+	programming[pAddr] = pack;
+	// perfect scheduling never actually programs anything so the sectors are done now
+	if(PERFECT_SCHEDULE)
+	{
+	    packedWriteDone(pAddr, currentClockCycle);
+	}
+    }
+}
+
+// the physical sector no longer holds anything anyone will read
+void SectorFtl::invalidate(uint64_t sAddr)
+{
+    unordered_map<uint64_t, uint64_t>::iterator it = reverseMap.find(sAddr);
+    // already erased out from under us
+    if(it == reverseMap.end())
+    {
+	return;
+    }
+    reverseMap.erase(it);
+
+    uint64_t block = sAddr / BLOCK_SIZE;
+    uint64_t page = sAddr - (sAddr % NV_PAGE_SIZE);
+    invalid_sectors[block]++;
+    invalid_sector_count++;
+    page_valid[page]--;
+    if(page_valid[page] == 0)
+    {
+	page_valid.erase(page);
+	dirty[block][(page / NV_PAGE_SIZE) % PAGES_PER_BLOCK] = true;
+	dirty_page_count++;
+    }
+}
+
+void SectorFtl::packedWriteDone(uint64_t pAddr, uint64_t cycle)
+{
+    unordered_map<uint64_t, SectorPack *>::iterator it = programming.find(pAddr);
+    if(it == programming.end())
+    {
+	return;
+    }
+    for(uint64_t i = 0; i < it->second->writes.size(); i++)
+    {
+	parent->writeDone(it->second->writes[i], cycle);
+    }
+    delete it->second;
+    programming.erase(it);
+}
+
+uint64_t SectorFtl::garbage(uint64_t block)
+{
+    return invalid_sectors[block];
+}
+
+bool SectorFtl::hasGarbage(void)
+{
+    return invalid_sector_count != 0;
+}
+
+// same as the gc ftl but every page that still has a valid sector is read once and only its valid sectors are moved
+void SectorFtl::addGC(uint64_t dirty_block)
+{
+     uint64_t page, pAddr, s;
+     FlashTransaction trans;
+     PendingErase temp_erase;
+
+     temp_erase.erase_block = dirty_block;
+
+     for (page = 0; page < PAGES_PER_BLOCK; page++) {
+	 if (used[dirty_block][page] == true && dirty[dirty_block][page] == false) {
+	     pAddr = (dirty_block * BLOCK_SIZE + page * NV_PAGE_SIZE);
+
+	     vector<pair<uint64_t, uint64_t> > moves;
+	     for (s = 0; s < sectors_per_page; s++) {
+		 unordered_map<uint64_t, uint64_t>::iterator it = reverseMap.find(pAddr + s * HOST_SECTOR_SIZE);
+		 if (it != reverseMap.end()) {
+		     moves.push_back(make_pair(it->second, it->first));
+		 }
+	     }
+	     assert(!moves.empty());
+
+	     // the read goes out under the first valid sector, that gets the whole page
+	     trans = FlashTransaction(GC_DATA_READ, moves.front().first, NULL);
+	     addGcTransaction(trans);
+	     gc_moves[moves.front().first] = moves;
+
+	     temp_erase.pending_reads.push_front(moves.front().first);
+	 }
+     }
+     if(temp_erase.pending_reads.empty())
+     {
+	 trans = FlashTransaction(BLOCK_ERASE, dirty_block * BLOCK_SIZE, NULL); 
+	 addGcTransaction(trans);
+     }
+     else
+     {
+	 gc_pending_erase.push_front(temp_erase);
+     }
+}
+
+void SectorFtl::GCReadDone(uint64_t vAddr)
+{
+    uint64_t erase_block;
+    bool erase = gcReadFinished(vAddr, erase_block);
+
+    vector<pair<uint64_t, uint64_t> > &moves = gc_moves[vAddr];
+    for (uint64_t i = 0; i < moves.size(); i++)
+    {
+	// skip anything the host has written again since the gc looked
+	if (addressMap.find(moves[i].first) == addressMap.end() || addressMap[moves[i].first] != moves[i].second)
+	    continue;
+
+	if (gc_pack == NULL)
+	{
+	    gc_pack = new SectorPack();
+	    gc_pack->first_write = currentClockCycle;
+	    gc_pack->gc = true;
+	}
+	gc_pack->writes.push_back(FlashTransaction(GC_DATA_WRITE, moves[i].first, NULL));
+	gc_pack->moved_from.push_back(moves[i].second);
+	if (gc_pack->writes.size() == sectors_per_page)
+	{
+	    queueGcPack();
+	}
+    }
+    gc_moves.erase(vAddr);
+
+    // that was the last read the erase was waiting on, so what's left goes out now as a partial page
+    // ahead of the erase so that gc mode doesn't end with it still in the queue
+    if (erase)
+    {
+	if (gc_pack != NULL)
+	{
+	    queueGcPack();
+	}
+	FlashTransaction trans = FlashTransaction(BLOCK_ERASE, erase_block * BLOCK_SIZE, NULL); 
+	addGcTransaction(trans);
+    }
+}
+
+void SectorFtl::blockErased(uint64_t block)
+{
+    uint64_t page, pAddr, s;
+
+    invalid_sector_count -= invalid_sectors[block];
+    invalid_sectors[block] = 0;
+    for (page = 0; page < PAGES_PER_BLOCK; page++)
+    {
+	pAddr = block * BLOCK_SIZE + page * NV_PAGE_SIZE;
+	page_valid.erase(pAddr);
+	for (s = 0; s < sectors_per_page; s++)
+	{
+	    reverseMap.erase(pAddr + s * HOST_SECTOR_SIZE);
+	}
+    }
+}
@@ -0,0 +1,109 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVSECTORFTL_H
+#define NVSECTORFTL_H
+//SectorFtl.h
+//header file for the gc ftl that maps host sectors rather than whole pages, see SECTOR_MAPPING
+//
+//Every host address is one HOST_SECTOR_SIZE sector and the address map takes
+//it to a sector inside a physical page, so several sectors share a page.
+//Host writes are packed into an open page in the order they arrive and the
+//page is programmed once it is full or has waited SECTOR_PACK_TIME cycles, a
+//small write never has to read the rest of its page back first. Each
+//physical sector is valid until its host sector is written again, a page only
+//counts as dirty once none of its sectors are valid. The gc picks the block
+//with the most invalid sectors and moves just the valid ones, packing them
+//into new pages the same way.
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "GCFtl.h"
+
+namespace NVDSim{
+        class NVDIMM;
+	class SectorFtl : public GCFtl{
+		public:
+	                SectorFtl(Controller *c, Logger *l, NVDIMM *p, uint64_t s);
+			bool addTransaction(FlashTransaction &t);
+			void update(void);
+			void write_used_handler(uint64_t vAddr);
+			void write_success(uint64_t block, uint64_t page, uint64_t vAddr, uint64_t pAddr, bool gc, bool mapped);
+			void addGC(uint64_t dirty_block);
+			uint64_t garbage(uint64_t block);
+			bool hasGarbage(void);
+
+			void GCReadDone(uint64_t vAddr);
+			void packedWriteDone(uint64_t pAddr, uint64_t cycle);
+
+		protected:
+			void blockErased(uint64_t block);
+
+		private:
+			// the sectors going into one page
+			// it rides along in the data pointer of its write, nothing else looks at that for writes
+			class SectorPack
+			{
+			public:
+			    std::vector<FlashTransaction> writes; // one per sector, in page order
+			    std::vector<uint64_t> moved_from; // gc only, where each sector was when the gc read it
+			    uint64_t first_write;
+			    bool gc;
+			};
+
+			void queuePacks(void);
+			void queueGcPack(void);
+			FlashTransaction packTransaction(SectorPack *pack);
+			void invalidate(uint64_t sAddr);
+
+			uint64_t sectors_per_page;
+
+			SectorPack *open_pack; // still taking host writes
+			std::list<SectorPack *> sealed; // full or old enough, waiting for room in the ftl queue
+			SectorPack *gc_pack; // valid sectors the gc has read back so far
+			std::unordered_map<uint64_t, SectorPack *> programming; // physical page to the host pack being programmed there
+			std::unordered_map<uint64_t, uint64_t> buffered; // host sector to how many packs hold it that haven't been placed yet
+			std::list<std::pair<uint64_t, FlashTransaction> > buffered_reads; // reads answered out of a pack and the cycle they're done
+
+			// each gc read brings in a whole page, these are the sectors on it that were valid at the time
+			// as pairs of host sector and physical sector
+			std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint64_t> > > gc_moves;
+
+			std::unordered_map<uint64_t, uint64_t> reverseMap; // physical sector to host sector, only while it is valid
+			std::unordered_map<uint64_t, uint64_t> page_valid; // physical page to how many of its sectors are valid
+			std::vector<uint64_t> invalid_sectors; // per block, includes the sectors a partly packed page never used
+			uint64_t invalid_sector_count;
+	};
+}
+#endif
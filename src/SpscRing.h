@@ -0,0 +1,112 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVSPSCRING_H
+#define NVSPSCRING_H
+
+//SpscRing.h
+//Fixed size ring for passing things from exactly one thread to exactly one other thread
+//
+//Only the producer writes tail and only the consumer writes head so neither side
+//ever has to take a lock. The size is rounded up to a power of two so wrapping
+//around is just a mask.
+
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+namespace NVDSim
+{
+    template <typename T>
+    class SpscRing
+    {
+    public:
+	SpscRing(uint64_t size)
+	{
+	    uint64_t capacity = 1;
+	    while (capacity < size)
+	    {
+		capacity = capacity << 1;
+	    }
+	    mask = capacity - 1;
+	    buffer = std::vector<T>(capacity);
+	    head.store(0);
+	    tail.store(0);
+	}
+
+	// producer side, false if the ring is full
+	bool push(const T &item)
+	{
+	    uint64_t t = tail.load(std::memory_order_relaxed);
+	    if (t - head.load(std::memory_order_acquire) > mask)
+	    {
+		return false;
+	    }
+	    buffer[t & mask] = item;
+	    tail.store(t + 1, std::memory_order_release);
+	    return true;
+	}
+
+	// consumer side, false if the ring is empty
+	bool pop(T &item)
+	{
+	    uint64_t h = head.load(std::memory_order_relaxed);
+	    if (h == tail.load(std::memory_order_acquire))
+	    {
+		return false;
+	    }
+	    item = buffer[h & mask];
+	    head.store(h + 1, std::memory_order_release);
+	    return true;
+	}
+
+	uint64_t capacity(void)
+	{
+	    return mask + 1;
+	}
+
+    private:
+	uint64_t mask;
+	std::vector<T> buffer;
+
+	// padding keeps the two counters on their own cache lines so the threads don't
+	// keep stealing the line from each other
+	char pad0[64];
+	std::atomic<uint64_t> head;
+	char pad1[64];
+	std::atomic<uint64_t> tail;
+	char pad2[64];
+    };
+}
+
+#endif
@@ -0,0 +1,309 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//Stats.cpp
+//Registry of the statistics the loggers keep so they can be dumped in a machine readable form
+
+#include <iomanip>
+
+#include "Stats.h"
+#include "FlashConfiguration.h"
+
+using namespace NVDSim;
+using namespace std;
+
+const uint64_t Histogram::NUM_BUCKETS;
+
+Histogram::Histogram()
+{
+	buckets = vector<uint64_t>(NUM_BUCKETS, 0);
+	count = 0;
+	sum = 0;
+	min = 0;
+	max = 0;
+}
+
+void Histogram::add(uint64_t value)
+{
+	uint64_t bucket = 0;
+	uint64_t v = value;
+	while (v != 0)
+	{
+	    bucket++;
+	    v >>= 1;
+	}
+	buckets[bucket]++;
+
+	if (count == 0 || value < min)
+	{
+	    min = value;
+	}
+	if (value > max)
+	{
+	    max = value;
+	}
+	count++;
+	sum += value;
+}
+
+double Histogram::mean(void)
+{
+	if (count == 0)
+	{
+	    return 0.0;
+	}
+	return (double)sum / (double)count;
+}
+
+uint64_t Histogram::percentile(double p)
+{
+	if (count == 0)
+	{
+	    return 0;
+	}
+
+	uint64_t target = (uint64_t)(p * count);
+	if (target >= count)
+	{
+	    target = count - 1;
+	}
+	uint64_t seen = 0;
+	for (uint64_t i = 0; i < NUM_BUCKETS; i++)
+	{
+	    seen += buckets[i];
+	    if (seen > target)
+	    {
+		if (i == 0)
+		{
+		    return 0;
+		}
+		// don't report more than we've actually seen
+		uint64_t upper = (i >= 64) ? ULLONG_MAX : ((1ULL << i) - 1);
+		return (upper < max) ? upper : max;
+	    }
+	}
+	return max;
+}
+
+StatsRegistry::StatsRegistry()
+{
+}
+
+void StatsRegistry::counter(string name, uint64_t *value)
+{
+	StatEntry s;
+	s.name = name;
+	s.type = COUNTER_STAT;
+	s.counter = value;
+	s.value = NULL;
+	stats.push_back(s);
+}
+
+void StatsRegistry::value(string name, double *value)
+{
+	StatEntry s;
+	s.name = name;
+	s.type = VALUE_STAT;
+	s.counter = NULL;
+	s.value = value;
+	stats.push_back(s);
+}
+
+void StatsRegistry::derived(string name, function<double(void)> fn)
+{
+	StatEntry s;
+	s.name = name;
+	s.type = DERIVED_STAT;
+	s.counter = NULL;
+	s.value = NULL;
+	s.fn = fn;
+	stats.push_back(s);
+}
+
+void StatsRegistry::histogram(string name, Histogram *hist)
+{
+	histograms.push_back(pair<string, Histogram *>(name, hist));
+}
+
+void StatsRegistry::save(string filename, string format, uint64_t cycle, uint64_t epoch)
+{
+	ofstream out;
+	out.open(filename.c_str(), ios_base::out | ios_base::trunc);
+	if (!out)
+	{
+	    ERROR("Cannot open "<<filename);
+	    exit(-1);
+	}
+
+	if (format.compare("json") == 0)
+	{
+	    write_json(out, cycle, epoch);
+	}
+	else
+	{
+	    write_csv_header(out);
+	    write_csv_row(out, cycle, epoch);
+	}
+	out.close();
+}
+
+void StatsRegistry::save_epoch(string filename, string format, uint64_t cycle, uint64_t epoch)
+{
+	if (!epochfile.is_open())
+	{
+	    epochfile.open(filename.c_str(), ios_base::out | ios_base::trunc);
+	    if (!epochfile)
+	    {
+		ERROR("Cannot open "<<filename);
+		exit(-1);
+	    }
+	    if (format.compare("csv") == 0)
+	    {
+		write_csv_header(epochfile);
+	    }
+	}
+
+	// json epochs are written one object per line so the file can be read as it grows
+	if (format.compare("json") == 0)
+	{
+	    write_json(epochfile, cycle, epoch);
+	}
+	else
+	{
+	    write_csv_row(epochfile, cycle, epoch);
+	}
+	epochfile.flush();
+}
+
+void StatsRegistry::write_json(ostream &out, uint64_t cycle, uint64_t epoch)
+{
+	out << setprecision(10);
+	out << "{\"cycle\": " << cycle << ", \"epoch\": " << epoch << ", \"stats\": {";
+	for (uint64_t i = 0; i < stats.size(); i++)
+	{
+	    if (i != 0)
+	    {
+		out << ", ";
+	    }
+	    out << "\"" << stats[i].name << "\": ";
+	    if (stats[i].type == COUNTER_STAT)
+	    {
+		out << *(stats[i].counter);
+	    }
+	    else if (stats[i].type == VALUE_STAT)
+	    {
+		out << *(stats[i].value);
+	    }
+	    else
+	    {
+		out << stats[i].fn();
+	    }
+	}
+	out << "}, \"histograms\": {";
+	for (uint64_t i = 0; i < histograms.size(); i++)
+	{
+	    Histogram *h = histograms[i].second;
+	    if (i != 0)
+	    {
+		out << ", ";
+	    }
+	    out << "\"" << histograms[i].first << "\": {\"count\": " << h->count << ", \"sum\": " << h->sum;
+	    out << ", \"min\": " << h->min << ", \"max\": " << h->max << ", \"mean\": " << h->mean();
+	    out << ", \"p50\": " << h->percentile(0.5) << ", \"p90\": " << h->percentile(0.9) << ", \"p99\": " << h->percentile(0.99);
+	    // drop the empty buckets off the end to keep things readable
+	    uint64_t last = 0;
+	    for (uint64_t j = 0; j < Histogram::NUM_BUCKETS; j++)
+	    {
+		if (h->buckets[j] != 0)
+		{
+		    last = j;
+		}
+	    }
+	    out << ", \"log2_buckets\": [";
+	    for (uint64_t j = 0; j <= last; j++)
+	    {
+		if (j != 0)
+		{
+		    out << ", ";
+		}
+		out << h->buckets[j];
+	    }
+	    out << "]}";
+	}
+	out << "}}\n";
+}
+
+void StatsRegistry::write_csv_header(ostream &out)
+{
+	out << "cycle,epoch";
+	for (uint64_t i = 0; i < stats.size(); i++)
+	{
+	    out << "," << stats[i].name;
+	}
+	for (uint64_t i = 0; i < histograms.size(); i++)
+	{
+	    string n = histograms[i].first;
+	    out << "," << n << ".count," << n << ".mean," << n << ".min," << n << ".max,";
+	    out << n << ".p50," << n << ".p90," << n << ".p99";
+	}
+	out << "\n";
+}
+
+void StatsRegistry::write_csv_row(ostream &out, uint64_t cycle, uint64_t epoch)
+{
+	out << setprecision(10);
+	out << cycle << "," << epoch;
+	for (uint64_t i = 0; i < stats.size(); i++)
+	{
+	    out << ",";
+	    if (stats[i].type == COUNTER_STAT)
+	    {
+		out << *(stats[i].counter);
+	    }
+	    else if (stats[i].type == VALUE_STAT)
+	    {
+		out << *(stats[i].value);
+	    }
+	    else
+	    {
+		out << stats[i].fn();
+	    }
+	}
+	for (uint64_t i = 0; i < histograms.size(); i++)
+	{
+	    Histogram *h = histograms[i].second;
+	    out << "," << h->count << "," << h->mean() << "," << h->min << "," << h->max;
+	    out << "," << h->percentile(0.5) << "," << h->percentile(0.9) << "," << h->percentile(0.99);
+	}
+	out << "\n";
+}
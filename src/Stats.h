@@ -0,0 +1,116 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVSTATS_H
+#define NVSTATS_H
+
+//Stats.h
+//Registry of the statistics the loggers keep so they can be dumped in a machine readable form
+//
+//The loggers register pointers to the counters they already maintain (plus any
+//derived values and histograms) once in their constructors. The registry then
+//serializes whatever is registered to json or csv, so adding a stat to the
+//machine readable output is one line in the constructor instead of another
+//hand formatted line in every save function.
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <stdint.h>
+
+namespace NVDSim
+{
+    // power of two buckets, bucket i counts values in [2^(i-1), 2^i)
+    class Histogram
+    {
+    public:
+	Histogram();
+	void add(uint64_t value);
+	double mean(void);
+	// approximate, returns the upper bound of the bucket the percentile lands in
+	uint64_t percentile(double p);
+
+	static const uint64_t NUM_BUCKETS = 65;
+	std::vector<uint64_t> buckets;
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+    };
+
+    enum StatType
+    {
+	COUNTER_STAT,
+	VALUE_STAT,
+	DERIVED_STAT
+    };
+
+    class StatsRegistry
+    {
+    public:
+	StatsRegistry();
+
+	void counter(std::string name, uint64_t *value);
+	void value(std::string name, double *value);
+	void derived(std::string name, std::function<double(void)> fn);
+	void histogram(std::string name, Histogram *hist);
+
+	// whole run summary, format is "json" or "csv"
+	void save(std::string filename, std::string format, uint64_t cycle, uint64_t epoch);
+	// one line per epoch appended to a file that stays open for the run
+	void save_epoch(std::string filename, std::string format, uint64_t cycle, uint64_t epoch);
+
+    private:
+	class StatEntry
+	{
+	public:
+	    std::string name;
+	    StatType type;
+	    uint64_t *counter;
+	    double *value;
+	    std::function<double(void)> fn;
+	};
+
+	void write_json(std::ostream &out, uint64_t cycle, uint64_t epoch);
+	void write_csv_header(std::ostream &out);
+	void write_csv_row(std::ostream &out, uint64_t cycle, uint64_t epoch);
+
+	std::vector<StatEntry> stats;
+	std::vector<std::pair<std::string, Histogram *> > histograms;
+
+	std::ofstream epochfile;
+    };
+}
+
+#endif
@@ -0,0 +1,342 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//Sweep.cpp
+//Fork based runner for a grid of configurations
+
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "Sweep.h"
+
+using namespace NVDSim;
+using namespace std;
+
+static string trim(string str)
+{
+    size_t begin = str.find_first_not_of(" \t\r");
+    if (begin == string::npos)
+    {
+	return "";
+    }
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(begin, end-begin+1);
+}
+
+static vector<string> split_csv(string line)
+{
+    vector<string> fields;
+    stringstream ss(line);
+    string field;
+    while (getline(ss, field, ','))
+    {
+	fields.push_back(trim(field));
+    }
+    return fields;
+}
+
+Sweep::Sweep(string baseIni, string outDir, uint64_t jobs)
+{
+    base_ini = baseIni;
+    out_dir = outDir;
+    if (out_dir.empty() || out_dir[out_dir.size()-1] != '/')
+    {
+	out_dir += "/";
+    }
+    this->jobs = (jobs == 0) ? 1 : jobs;
+}
+
+void Sweep::add_param(string key, vector<string> values)
+{
+    if (values.empty())
+    {
+	ERROR("sweep parameter "<<key<<" has no values");
+	exit(-1);
+    }
+    keys.push_back(key);
+    this->values.push_back(values);
+}
+
+// grid files look like ini files except each key takes a comma separated list of values
+void Sweep::read_grid(string filename)
+{
+    ifstream gridFile;
+    string line;
+    size_t lineNumber = 0;
+
+    gridFile.open(filename.c_str());
+    if (!gridFile.is_open())
+    {
+	ERROR("Unable to load sweep grid file "<<filename);
+	exit(-1);
+    }
+
+    while (getline(gridFile, line))
+    {
+	lineNumber++;
+	size_t commentIndex = line.find_first_of(";");
+	if (commentIndex != string::npos)
+	{
+	    line = line.substr(0, commentIndex);
+	}
+	line = trim(line);
+	if (line.empty())
+	{
+	    continue;
+	}
+
+	size_t equalsIndex = line.find_first_of("=");
+	if (equalsIndex == string::npos)
+	{
+	    ERROR("Malformed sweep grid line "<<lineNumber<<" (missing equals)");
+	    exit(-1);
+	}
+	add_param(trim(line.substr(0, equalsIndex)), split_csv(line.substr(equalsIndex+1)));
+    }
+}
+
+uint64_t Sweep::num_configs(void)
+{
+    uint64_t configs = 1;
+    for (uint64_t i = 0; i < values.size(); i++)
+    {
+	configs *= values[i].size();
+    }
+    return configs;
+}
+
+vector<string> Sweep::config_values(uint64_t config)
+{
+    vector<string> config_vals = vector<string>(keys.size(), "");
+    for (uint64_t i = keys.size(); i > 0; i--)
+    {
+	config_vals[i-1] = values[i-1][config % values[i-1].size()];
+	config /= values[i-1].size();
+    }
+    return config_vals;
+}
+
+string Sweep::config_dir(uint64_t config)
+{
+    stringstream dir;
+    dir << out_dir << "run" << config << "/";
+    return dir.str();
+}
+
+void Sweep::run(SweepWorkload workload)
+{
+    string command_str = "test -e "+out_dir+" || mkdir "+out_dir;
+    const char * command = command_str.c_str();
+    int sys_done = system(command);
+    if (sys_done != 0)
+    {
+	WARNING("Something might have gone wrong when creating the sweep output directory");
+    }
+
+    uint64_t configs = num_configs();
+    vector<int> status = vector<int>(configs, -1);
+    map<pid_t, uint64_t> running;
+
+    PRINT("Sweeping "<<configs<<" configurations with "<<jobs<<" jobs");
+
+    // anything still sitting in the stdio buffers would get written again by every child
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+
+    for (uint64_t config = 0; config <= configs; config++)
+    {
+	// wait for a free slot, or for everything once all of the configurations are started
+	while (!running.empty() && (running.size() >= jobs || config == configs))
+	{
+	    int child_status;
+	    pid_t pid = waitpid(-1, &child_status, 0);
+	    if (pid < 0)
+	    {
+		ERROR("waitpid failed while "<<running.size()<<" sweep configurations were still running");
+		exit(-1);
+	    }
+	    if (running.count(pid) == 0)
+	    {
+		continue;
+	    }
+
+	    uint64_t done = running[pid];
+	    running.erase(pid);
+	    status[done] = WIFEXITED(child_status) ? WEXITSTATUS(child_status) : -1;
+	    PRINT("Sweep configuration "<<done<<" finished with status "<<status[done]);
+	}
+
+	if (config == configs)
+	{
+	    break;
+	}
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+	    ERROR("Could not fork sweep configuration "<<config);
+	    exit(-1);
+	}
+	else if (pid == 0)
+	{
+	    run_config(config, workload);
+	    exit(0);
+	}
+	running[pid] = config;
+    }
+
+    merge_results(status);
+}
+
+// this is the child side, it never returns to the sweep loop
+void Sweep::run_config(uint64_t config, SweepWorkload workload)
+{
+    string dir = config_dir(config);
+    string command_str = "test -e "+dir+" || mkdir "+dir;
+    const char * command = command_str.c_str();
+    int sys_done = system(command);
+    if (sys_done != 0)
+    {
+	WARNING("Something might have gone wrong when creating the sweep run directory");
+    }
+
+    // keep the concurrent runs from interleaving on the terminal
+    if (freopen((dir+"run.log").c_str(), "w", stdout) == NULL)
+    {
+	ERROR("Could not open "<<dir<<"run.log");
+	exit(-1);
+    }
+    dup2(fileno(stdout), fileno(stderr));
+
+    vector<string> override_keys = keys;
+    vector<string> override_values = config_values(config);
+
+    // the merged table is built from the csv stats so those have to be on
+    override_keys.push_back("LOGGING");
+    override_values.push_back("1");
+    override_keys.push_back("LOG_DIR");
+    override_values.push_back(dir);
+    override_keys.push_back("STATS_FORMAT");
+    override_values.push_back("csv");
+
+    NVDIMM *NVDimm = new NVDIMM(config, base_ini, "", "", "", override_keys, override_values);
+    workload(NVDimm);
+    NVDimm->saveStats();
+
+    cout.flush();
+    cerr.flush();
+}
+
+void Sweep::merge_results(vector<int> &status)
+{
+    vector<string> columns;
+    map<string, uint64_t> column_index;
+    vector<map<string, string> > rows = vector<map<string, string> >(status.size());
+
+    // runs with different parameters can register different stats (gc on vs off), so take the union
+    for (uint64_t config = 0; config < status.size(); config++)
+    {
+	ifstream statsFile;
+	string header_line, value_line;
+
+	statsFile.open((config_dir(config)+"NVDIMM_STATS.csv").c_str());
+	if (!statsFile.is_open() || !getline(statsFile, header_line) || !getline(statsFile, value_line))
+	{
+	    if (status[config] == 0)
+	    {
+		WARNING("Sweep configuration "<<config<<" finished but did not write any stats");
+		status[config] = -1;
+	    }
+	    continue;
+	}
+
+	vector<string> header = split_csv(header_line);
+	vector<string> vals = split_csv(value_line);
+	for (uint64_t i = 0; i < header.size() && i < vals.size(); i++)
+	{
+	    if (column_index.count(header[i]) == 0)
+	    {
+		column_index[header[i]] = columns.size();
+		columns.push_back(header[i]);
+	    }
+	    rows[config][header[i]] = vals[i];
+	}
+    }
+
+    ofstream resultsFile;
+    resultsFile.open((out_dir+"sweep_results.csv").c_str(), ios_base::out | ios_base::trunc);
+    if (!resultsFile.is_open())
+    {
+	ERROR("Could not open "<<out_dir<<"sweep_results.csv");
+	exit(-1);
+    }
+
+    resultsFile<<"run,status";
+    for (uint64_t i = 0; i < keys.size(); i++)
+    {
+	resultsFile<<","<<keys[i];
+    }
+    for (uint64_t i = 0; i < columns.size(); i++)
+    {
+	resultsFile<<","<<columns[i];
+    }
+    resultsFile<<"\n";
+
+    for (uint64_t config = 0; config < status.size(); config++)
+    {
+	vector<string> config_vals = config_values(config);
+	resultsFile<<config<<","<<(status[config] == 0 ? "ok" : "failed");
+	for (uint64_t i = 0; i < config_vals.size(); i++)
+	{
+	    resultsFile<<","<<config_vals[i];
+	}
+	for (uint64_t i = 0; i < columns.size(); i++)
+	{
+	    resultsFile<<",";
+	    if (rows[config].count(columns[i]) != 0)
+	    {
+		resultsFile<<rows[config][columns[i]];
+	    }
+	}
+	resultsFile<<"\n";
+    }
+
+    resultsFile.close();
+    PRINT("Sweep results written to "<<out_dir<<"sweep_results.csv");
+}
@@ -0,0 +1,84 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVSWEEP_H
+#define NVSWEEP_H
+
+//Sweep.h
+//Runs a grid of configurations built from one base ini file and merges their stats into one table
+//
+//All of the device parameters are globals, so two NVDIMMs with different
+//configurations cannot live in the same process. Each configuration is run in
+//its own forked child instead, with at most jobs children going at once. Every
+//child writes its logs and a csv stats file to its own directory under the
+//output directory, and the parent collects those into sweep_results.csv when
+//everything is done.
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdint.h>
+
+#include "NVDIMM.h"
+
+namespace NVDSim
+{
+    // drives the simulation for one configuration, saveStats is called once it returns
+    typedef std::function<void(NVDIMM *)> SweepWorkload;
+
+    class Sweep
+    {
+    public:
+	Sweep(std::string baseIni, std::string outDir, uint64_t jobs);
+	void add_param(std::string key, std::vector<std::string> values);
+	void read_grid(std::string filename);
+	uint64_t num_configs(void);
+	void run(SweepWorkload workload);
+
+    private:
+	std::vector<std::string> config_values(uint64_t config);
+	std::string config_dir(uint64_t config);
+	void run_config(uint64_t config, SweepWorkload workload);
+	void merge_results(std::vector<int> &status);
+
+	std::string base_ini;
+	std::string out_dir;
+	uint64_t jobs;
+
+	// one entry per swept parameter, the first key changes slowest
+	std::vector<std::string> keys;
+	std::vector<std::vector<std::string> > values;
+    };
+}
+
+#endif
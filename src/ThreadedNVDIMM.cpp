@@ -0,0 +1,240 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//ThreadedNVDIMM.cpp
+//Runs an NVDIMM on its own thread so its cost overlaps with the host simulator
+
+#include "ThreadedNVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+ThreadedNVDIMM::ThreadedNVDIMM(NVDIMM *nv, uint64_t q, uint64_t ring_size) :
+	requests(ring_size),
+	completions(ring_size)
+{
+	if (q == 0)
+	{
+	    ERROR("The threaded nvdimm quantum must be at least one cycle");
+	    exit(-1);
+	}
+	if (ring_size == 0)
+	{
+	    ERROR("The threaded nvdimm rings need room for at least one entry");
+	    exit(-1);
+	}
+
+	nvdimm = nv;
+	quantum = q;
+	host_cycle = 0;
+	held = 0;
+
+	staged.reserve(requests.capacity());
+	ready.reserve(completions.capacity());
+	handed.reserve(completions.capacity());
+
+	// the nvdimm thread picks up its completions in bulk instead of through the callbacks
+	nvdimm->RegisterCompletionQueue(completions.capacity());
+
+	// the first quantum can start right away
+	granted.store(quantum);
+	done.store(0);
+	backlog.store(0);
+	stopping.store(false);
+	stopped = false;
+	worker = thread(&ThreadedNVDIMM::nvdimm_loop, this);
+}
+
+ThreadedNVDIMM::~ThreadedNVDIMM()
+{
+	stop();
+}
+
+ThreadedNVDIMM *NVDSim::getThreadedNVDIMMInstance(NVDIMM *nv, uint64_t quantum, uint64_t ringSize)
+{
+	return new ThreadedNVDIMM(nv, quantum, ringSize);
+}
+
+void NVDSim::destroyThreadedNVDIMMInstance(ThreadedNVDIMM *threaded)
+{
+	delete threaded;
+}
+
+bool ThreadedNVDIMM::add(FlashTransaction &trans)
+{
+	// the ring is always empty at a boundary, but what the nvdimm turned away is still waiting for
+	// room too so the host has to see that as backpressure instead of piling more up behind it
+	if (stopped || staged.size() + held >= requests.capacity())
+	{
+	    return false;
+	}
+	// the wait for the boundary and in pending counts toward the latency, same as without the thread
+	trans.timeAdded = host_cycle;
+	staged.push_back(trans);
+	return true;
+}
+
+bool ThreadedNVDIMM::addTransaction(bool isWrite, uint64_t addr)
+{
+	FlashTransaction trans = FlashTransaction(isWrite ? DATA_WRITE : DATA_READ, addr, NULL);
+	return add(trans);
+}
+
+void ThreadedNVDIMM::update(void)
+{
+	host_cycle++;
+	if (host_cycle % quantum == 0)
+	{
+	    sync();
+	}
+}
+
+uint64_t ThreadedNVDIMM::drainCompletions(const CompletionRecord **records)
+{
+	handed.swap(ready);
+	ready.clear();
+	*records = handed.data();
+	return handed.size();
+}
+
+void ThreadedNVDIMM::printStats(void)
+{
+	wait_for_nvdimm();
+	nvdimm->printStats();
+}
+
+void ThreadedNVDIMM::saveStats(void)
+{
+	wait_for_nvdimm();
+	nvdimm->saveStats();
+}
+
+void ThreadedNVDIMM::stop(void)
+{
+	if (stopped)
+	{
+	    return;
+	}
+	wait_for_nvdimm();
+	stopping.store(true, memory_order_release);
+	worker.join();
+	stopped = true;
+}
+
+// end of a host quantum, trade requests for completions and start the next quantum
+void ThreadedNVDIMM::sync(void)
+{
+	if (stopped)
+	{
+	    return;
+	}
+	wait_for_nvdimm();
+	held = backlog.load(memory_order_relaxed);
+
+	// the nvdimm thread emptied the ring when it started the quantum that just ended
+	for (uint64_t i = 0; i < staged.size(); i++)
+	{
+	    requests.push(staged[i]);
+	}
+	staged.clear();
+
+	granted.store(host_cycle + quantum, memory_order_release);
+}
+
+// keep the completion ring moving while we wait or the nvdimm thread could get stuck on it
+void ThreadedNVDIMM::wait_for_nvdimm(void)
+{
+	while (done.load(memory_order_acquire) < granted.load(memory_order_relaxed))
+	{
+	    pull_completions();
+	    this_thread::yield();
+	}
+	pull_completions();
+}
+
+void ThreadedNVDIMM::pull_completions(void)
+{
+	CompletionRecord record;
+	while (completions.pop(record))
+	{
+	    ready.push_back(record);
+	}
+}
+
+void ThreadedNVDIMM::nvdimm_loop(void)
+{
+	uint64_t cycle = 0;
+	while (true)
+	{
+	    uint64_t target = granted.load(memory_order_acquire);
+	    if (target == cycle)
+	    {
+		if (stopping.load(memory_order_acquire))
+		{
+		    return;
+		}
+		this_thread::yield();
+		continue;
+	    }
+
+	    // everything the host added during the last quantum shows up at the start of this one
+	    FlashTransaction trans;
+	    while (requests.pop(trans))
+	    {
+		pending.push_back(trans);
+	    }
+
+	    for (; cycle < target; cycle++)
+	    {
+		// anything the nvdimm turned away just gets tried again the next cycle
+		while (!pending.empty() && nvdimm->addHeld(pending.front()))
+		{
+		    pending.pop_front();
+		}
+
+		nvdimm->update();
+
+		const CompletionRecord *records;
+		uint64_t count = nvdimm->drainCompletions(&records);
+		for (uint64_t i = 0; i < count; i++)
+		{
+		    while (!completions.push(records[i]))
+		    {
+			this_thread::yield();
+		    }
+		}
+	    }
+	    backlog.store(pending.size(), memory_order_relaxed);
+	    done.store(cycle, memory_order_release);
+	}
+}
@@ -0,0 +1,119 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVTHREADEDNVDIMM_H
+#define NVTHREADEDNVDIMM_H
+
+//ThreadedNVDIMM.h
+//Runs an NVDIMM on its own thread so its cost overlaps with the host simulator
+//
+//The host calls update once per cycle just like it would on the NVDIMM. The
+//two sides only meet every quantum cycles: at each boundary the host waits for
+//the NVDIMM thread to finish the same quantum, hands over the requests it made
+//during that quantum and picks up the completions, then lets the NVDIMM thread
+//go on with the next quantum while the host does the same. Requests and
+//completions cross over through lock free rings. Everything only changes hands
+//at the boundaries so a run gives the same results every time, but a request
+//can wait up to a quantum before the NVDIMM sees it and a completion can wait
+//up to a quantum before the host sees it. The host can only have as many
+//requests waiting on the NVDIMM as the request ring holds, counting the ones
+//the NVDIMM turned away and is still trying, so a full device pushes back on
+//the host like it would without the thread.
+
+#include <vector>
+#include <list>
+#include <thread>
+#include <atomic>
+#include <stdint.h>
+
+#include "NVDIMM.h"
+#include "SpscRing.h"
+
+namespace NVDSim
+{
+    class ThreadedNVDIMM
+    {
+    public:
+	// ring_size is also the most requests the host can have waiting on the nvdimm
+	ThreadedNVDIMM(NVDIMM *nv, uint64_t quantum, uint64_t ring_size);
+	~ThreadedNVDIMM();
+
+	// host side, none of these can be called from more than one host thread
+	// false once ring_size requests are waiting on the nvdimm, either added this quantum or turned away by it before
+	bool add(FlashTransaction &trans);
+	bool addTransaction(bool isWrite, uint64_t addr);
+	void update(void);
+	// completions handed over at the last boundary, valid until the next call
+	uint64_t drainCompletions(const CompletionRecord **records);
+	void printStats(void);
+	void saveStats(void);
+	// waits for the NVDIMM thread to finish and shuts it down
+	void stop(void);
+
+	NVDIMM *nvdimm;
+
+    private:
+	void sync(void);
+	void wait_for_nvdimm(void);
+	void pull_completions(void);
+	void nvdimm_loop(void);
+
+	uint64_t quantum;
+	uint64_t host_cycle;
+
+	// only touched by the host thread
+	std::vector<FlashTransaction> staged;
+	std::vector<CompletionRecord> ready;
+	std::vector<CompletionRecord> handed;
+	uint64_t held; // what was left in pending at the last boundary
+
+	// only touched by the nvdimm thread
+	std::list<FlashTransaction> pending; // turned away by the nvdimm, tried again every cycle
+
+	SpscRing<FlashTransaction> requests;
+	SpscRing<CompletionRecord> completions;
+
+	// the nvdimm thread may run up to granted and has finished everything before done
+	std::atomic<uint64_t> granted;
+	std::atomic<uint64_t> done;
+	std::atomic<uint64_t> backlog; // size of pending when the nvdimm thread finished its quantum
+	std::atomic<bool> stopping;
+	bool stopped;
+	std::thread worker;
+    };
+
+    ThreadedNVDIMM *getThreadedNVDIMMInstance(NVDIMM *nv, uint64_t quantum, uint64_t ringSize);
+    void destroyThreadedNVDIMMInstance(ThreadedNVDIMM *threaded);
+}
+
+#endif
@@ -45,7 +45,10 @@
 #include "FlashConfiguration.h"
 #include "FlashTransaction.h"
 #include <time.h>
+#include <unistd.h>
 #include "TraceBasedSim.h"
+#include "ThreadedNVDIMM.h"
+#include "Sweep.h"
 
 #define NUM_WRITES 10
 #define SIM_CYCLES 1000000
@@ -79,8 +82,24 @@ namespace NVDSim
 using namespace NVDSim;
 using namespace std;
 
-int main(void){
+int main(int argc, char *argv[]){
 	test_obj t;
+
+	// NVDSim sweep <base ini> <grid file> <output dir> [jobs]
+	if (argc >= 5 && string(argv[1]) == "sweep"){
+		uint64_t jobs = (argc >= 6) ? strtoull(argv[5], NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+		Sweep sweep(argv[2], argv[4], jobs);
+		sweep.read_grid(argv[3]);
+		sweep.run([&t](NVDIMM *NVDimm) { t.run_workload(NVDimm); });
+		return 0;
+	}
+
+	// NVDSim threaded [quantum]
+	if (argc >= 2 && string(argv[1]) == "threaded"){
+		t.run_threaded_test((argc >= 3) ? strtoull(argv[2], NULL, 10) : 1000);
+		return 0;
+	}
+
 	t.run_test();
 	return 0;
 }
@@ -139,15 +158,82 @@ void test_obj::power_cb(uint64_t id, vector<vector<double>> data, uint64_t cycle
 
 void test_obj::run_test(void){
 	clock_t start= clock(), end;
-	uint64_t cycle;
 	NVDIMM *NVDimm= new NVDIMM(1,"ini/samsung_K9XXG08UXM_gc_test.ini","ini/def_system.ini","","");
 	//NVDIMM *NVDimm= new NVDIMM(1,"ini/PCM_TEST.ini","ini/def_system.ini","","");
+
+	run_workload(NVDimm);
+	NVDimm->saveStats();
+
+	end= clock();
+	cout<<"Execution time: "<<(end-start)<<" cycles. "<<(double)(end-start)/CLOCKS_PER_SEC<<" seconds.\n";
+
+	//cout<<"Callback test: \n";
+	//NVDimm->powerCallback();
+}
+
+// the same writes as run_test with the nvdimm on its own thread, the completions should match
+// except that each one can come back up to a quantum later
+void test_obj::run_threaded_test(uint64_t quantum){
+	clock_t start= clock(), end;
+	NVDIMM *NVDimm= new NVDIMM(1,"ini/samsung_K9XXG08UXM_gc_test.ini","ini/def_system.ini","","");
+	ThreadedNVDIMM *threaded= getThreadedNVDIMMInstance(NVDimm, quantum, 64);
+
+	uint64_t cycle;
+	FlashTransaction t;
+	int writes = 0;
+	int write_addr = 0;
+
+	for (cycle= 0; cycle<SIM_CYCLES; cycle++){
+	  if(writes < NUM_WRITES){
+	      t = FlashTransaction(DATA_WRITE, write_addr, (void *)0xdeadbeef);
+	      // nothing tells the host when there is room again so just try the next cycle
+	      if((*threaded).add(t))
+	      {
+		  writes++;
+		  write_addr++;
+		  if(write_addr > 6)
+		  {
+		      write_addr = 0;
+		  }
+	      }
+	  }
+
+	  (*threaded).update();
+
+	  const CompletionRecord *records;
+	  uint64_t count = (*threaded).drainCompletions(&records);
+	  for (uint64_t i = 0; i < count; i++){
+	      if(records[i].type == READ_COMPLETION)
+		  read_cb(1, records[i].address, records[i].cycle, records[i].mapped);
+	      else if(records[i].type == CRIT_LINE_COMPLETION)
+		  crit_cb(1, records[i].address, records[i].cycle, records[i].mapped);
+	      else
+		  write_cb(1, records[i].address, records[i].cycle, records[i].mapped);
+	  }
+	}
+	threaded->stop();
+
+	cout<<"Simulation Results:\n";
+	cout<<"Cycles simulated: "<<cycle<<endl;
+	NVDimm->printStats();
+	NVDimm->saveStats();
+	destroyThreadedNVDIMMInstance(threaded);
+
+	end= clock();
+	cout<<"Execution time: "<<(end-start)<<" cycles. "<<(double)(end-start)/CLOCKS_PER_SEC<<" seconds.\n";
+}
+
+void test_obj::run_workload(NVDIMM *NVDimm){
+	uint64_t cycle;
 	typedef CallbackBase<void,uint64_t,uint64_t,uint64_t,bool> Callback_t;
 	Callback_t *r = new Callback<test_obj, void, uint64_t, uint64_t, uint64_t, bool>(this, &test_obj::read_cb);
 	Callback_t *c = new Callback<test_obj, void, uint64_t, uint64_t, uint64_t, bool>(this, &test_obj::crit_cb);
 	Callback_t *w = new Callback<test_obj, void, uint64_t, uint64_t, uint64_t, bool>(this, &test_obj::write_cb);
 	Callback_v *p = new Callback<test_obj, void, uint64_t, vector<vector<double>>, uint64_t, bool>(this, &test_obj::power_cb);
 	NVDimm->RegisterCallbacks(r, c, w, p);
+	ready_flag ready;
+	Callback_t *a = new Callback<ready_flag, void, uint64_t, uint64_t, uint64_t, bool>(&ready, &ready_flag::ready_cb);
+	NVDimm->RegisterReadyCallback(a);
 	
 	FlashTransaction t;
 
@@ -163,10 +249,14 @@ void test_obj::run_test(void){
 	int write_addr = 0;
 	
 	for (cycle= 0; cycle<SIM_CYCLES; cycle++){
-	  if(writes < NUM_WRITES){
+	  if(writes < NUM_WRITES && !ready.parked){
 	      t = FlashTransaction(DATA_WRITE, write_addr, (void *)0xdeadbeef);
 	      result = (*NVDimm).add(t);
-	      if(result == 1)
+	      if(result == 0)
+	      {
+		  ready.parked = true;
+	      }
+	      else
 	      {
 		  writes++;
 		  write_addr++;
@@ -190,13 +280,9 @@ void test_obj::run_test(void){
 			break;
 	}
 
-	end= clock();
 	cout<<"Simulation Results:\n";
 	cout<<"Cycles simulated: "<<cycle<<endl;
 	NVDimm->printStats();
-	NVDimm->saveStats();
-	cout<<"Execution time: "<<(end-start)<<" cycles. "<<(double)(end-start)/CLOCKS_PER_SEC<<" seconds.\n";
-
-	//cout<<"Callback test: \n";
-	//NVDimm->powerCallback();
+	NVDimm->RegisterReadyCallback(NULL);
+	delete a;
 }
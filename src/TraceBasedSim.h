@@ -43,5 +43,16 @@ public:
     void write_cb(uint64_t, uint64_t, uint64_t, bool);
     void power_cb(uint64_t, vector<vector<double>>, uint64_t, bool);
     void run_test(void);
+    void run_threaded_test(uint64_t quantum);
+    void run_workload(NVDSim::NVDIMM *NVDimm);
+};
+
+// one per workload run so sweep jobs don't share it
+// the next request is held back after the nvdimm turns it away until it says there is room
+class ready_flag{
+public:
+    ready_flag() : parked(false) {}
+    void ready_cb(uint64_t, uint64_t, uint64_t, bool) { parked = false; }
+    bool parked;
 };
 #endif
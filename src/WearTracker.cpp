@@ -0,0 +1,168 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//WearTracker.cpp
+//Bounded memory write frequency tracking for the wear level logs
+
+#include <algorithm>
+
+#include "WearTracker.h"
+#include "FlashConfiguration.h"
+
+using namespace NVDSim;
+using namespace std;
+
+WearTracker::WearTracker(uint64_t width, uint64_t depth, uint64_t top_k, uint64_t num_blocks)
+{
+	if (width == 0 || depth == 0)
+	{
+	    ERROR("Wear sketch width and depth must be greater than 0");
+	    exit(-1);
+	}
+
+	this->width = width;
+	this->depth = depth;
+	this->top_k = top_k;
+
+	sketch = vector<uint64_t>(width * depth, 0);
+	heavy_min = 0;
+	total_writes = 0;
+
+	block_erases = vector<uint64_t>(num_blocks, 0);
+	total_erases = 0;
+}
+
+// each row needs its own independent hash, so mix the address with a per row seed
+uint64_t WearTracker::hash(uint64_t paddr, uint64_t row)
+{
+	uint64_t x = paddr + (row + 1) * 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	x = x ^ (x >> 31);
+	return x % width;
+}
+
+void WearTracker::write(uint64_t paddr)
+{
+	total_writes++;
+
+	uint64_t est = ULLONG_MAX;
+	for (uint64_t i = 0; i < depth; i++)
+	{
+	    uint64_t &counter = sketch[i * width + hash(paddr, i)];
+	    counter++;
+	    if (counter < est)
+	    {
+		est = counter;
+	    }
+	}
+
+	if (top_k == 0)
+	{
+	    return;
+	}
+
+	unordered_map<uint64_t, uint64_t>::iterator it = heavy.find(paddr);
+	if (it != heavy.end())
+	{
+	    it->second = est;
+	    return;
+	}
+
+	if (heavy.size() < top_k)
+	{
+	    heavy[paddr] = est;
+	    if (heavy.size() == top_k)
+	    {
+		heavy_min = ULLONG_MAX;
+		for (it = heavy.begin(); it != heavy.end(); it++)
+		{
+		    heavy_min = min(heavy_min, it->second);
+		}
+	    }
+	    return;
+	}
+
+	// only go looking for the smallest entry to replace if we could actually beat it
+	if (est > heavy_min)
+	{
+	    unordered_map<uint64_t, uint64_t>::iterator victim = heavy.begin();
+	    for (it = heavy.begin(); it != heavy.end(); it++)
+	    {
+		if (it->second < victim->second)
+		{
+		    victim = it;
+		}
+	    }
+	    heavy.erase(victim);
+	    heavy[paddr] = est;
+
+	    heavy_min = ULLONG_MAX;
+	    for (it = heavy.begin(); it != heavy.end(); it++)
+	    {
+		heavy_min = min(heavy_min, it->second);
+	    }
+	}
+}
+
+void WearTracker::erase(uint64_t paddr)
+{
+	uint64_t block = paddr / BLOCK_SIZE;
+	if (block < block_erases.size())
+	{
+	    block_erases[block]++;
+	    total_erases++;
+	}
+}
+
+uint64_t WearTracker::estimate(uint64_t paddr)
+{
+	uint64_t est = ULLONG_MAX;
+	for (uint64_t i = 0; i < depth; i++)
+	{
+	    est = min(est, sketch[i * width + hash(paddr, i)]);
+	}
+	return est;
+}
+
+static bool more_writes(const pair<uint64_t, uint64_t> &a, const pair<uint64_t, uint64_t> &b)
+{
+	return a.second > b.second;
+}
+
+vector<pair<uint64_t, uint64_t> > WearTracker::top_writes(void)
+{
+	vector<pair<uint64_t, uint64_t> > top(heavy.begin(), heavy.end());
+	sort(top.begin(), top.end(), more_writes);
+	return top;
+}
@@ -0,0 +1,85 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVWEARTRACKER_H
+#define NVWEARTRACKER_H
+
+//WearTracker.h
+//Bounded memory write frequency tracking for the wear level logs
+//
+//Keeping an exact count for every physical address that has been written grows
+//with the footprint of the workload, so instead the counts go into a count-min
+//sketch and we only remember the addresses that look like the heaviest hitters.
+//The estimates can only over count, never under count.
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace NVDSim
+{
+    class WearTracker
+    {
+    public:
+	WearTracker(uint64_t width, uint64_t depth, uint64_t top_k, uint64_t num_blocks);
+
+	void write(uint64_t paddr);
+	void erase(uint64_t paddr);
+
+	uint64_t estimate(uint64_t paddr);
+
+	// heaviest written addresses, sorted most writes first
+	std::vector<std::pair<uint64_t, uint64_t> > top_writes(void);
+
+	uint64_t total_writes;
+
+	// one counter per physical block, indexed by paddr / BLOCK_SIZE
+	std::vector<uint64_t> block_erases;
+	uint64_t total_erases;
+
+    private:
+	uint64_t hash(uint64_t paddr, uint64_t row);
+
+	uint64_t width;
+	uint64_t depth;
+	uint64_t top_k;
+
+	std::vector<uint64_t> sketch; // depth rows of width counters laid out row after row
+
+	// candidate heavy hitters and their estimated counts
+	std::unordered_map<uint64_t, uint64_t> heavy;
+	uint64_t heavy_min; // smallest count in heavy, only valid when heavy is full
+    };
+}
+
+#endif
@@ -0,0 +1,236 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//WriteBuffer.cpp
+//Write back DRAM buffer in front of the ftl that combines line sized host writes into pages
+
+#include "WriteBuffer.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+WriteBuffer::WriteBuffer(NVDIMM *parent, Logger *l)
+{
+	parentNVDIMM = parent;
+	log = l;
+	lines_per_page = NV_PAGE_SIZE / WRITE_BUFFER_LINE_SIZE;
+	host_waiting = false;
+	currentClockCycle = 0;
+}
+
+bool WriteBuffer::write(const FlashTransaction &trans)
+{
+	uint64_t page = trans.address - (trans.address % NV_PAGE_SIZE);
+	uint64_t line = (trans.address % NV_PAGE_SIZE) / WRITE_BUFFER_LINE_SIZE;
+	bool merged = true;
+
+	unordered_map<uint64_t, list<BufferedPage>::iterator>::iterator it = where.find(page);
+	if (it == where.end())
+	{
+		if (pages.size() >= WRITE_BUFFER_PAGES)
+		{
+			// make room by getting rid of the oldest page, the host has to try again once it's gone
+			if (!pages.front().flush_wanted)
+			{
+				wantFlush(pages.front(), EVICTION_FLUSH);
+			}
+			host_waiting = true;
+			return false;
+		}
+
+		BufferedPage p;
+		p.page = page;
+		p.dirty = vector<bool>(lines_per_page, false);
+		p.lines_dirty = 0;
+		p.first_write = currentClockCycle;
+		p.flush_wanted = false;
+		p.filling = false;
+		p.filled = false;
+		p.reason = FULL_PAGE_FLUSH;
+		pages.push_back(p);
+		it = where.insert(make_pair(page, --pages.end())).first;
+		merged = false;
+	}
+
+	BufferedPage &p = *(it->second);
+	bool rewrite = p.dirty[line];
+	if (!rewrite)
+	{
+		p.dirty[line] = true;
+		p.lines_dirty++;
+	}
+	if (p.lines_dirty == lines_per_page && !p.flush_wanted)
+	{
+		wantFlush(p, FULL_PAGE_FLUSH);
+	}
+
+	if (LOGGING)
+	{
+		log->write_buffer_write(merged, rewrite);
+	}
+	return true;
+}
+
+bool WriteBuffer::forward(uint64_t page, uint64_t offset, uint64_t size)
+{
+	unordered_map<uint64_t, list<BufferedPage>::iterator>::iterator it = where.find(page);
+	if (it == where.end())
+	{
+		return false;
+	}
+	BufferedPage &p = *(it->second);
+	if (p.lines_dirty < lines_per_page && !p.filled)
+	{
+		for (uint64_t line = offset / WRITE_BUFFER_LINE_SIZE; line <= (offset + size - 1) / WRITE_BUFFER_LINE_SIZE; line++)
+		{
+			if (!p.dirty[line])
+			{
+				return false;
+			}
+		}
+	}
+	if (LOGGING)
+	{
+		log->write_buffer_forward();
+	}
+	return true;
+}
+
+bool WriteBuffer::holds(uint64_t page)
+{
+	return where.find(page) != where.end();
+}
+
+void WriteBuffer::fillDone(uint64_t page)
+{
+	unordered_map<uint64_t, list<BufferedPage>::iterator>::iterator it = where.find(page);
+	if (it != where.end())
+	{
+		it->second->filling = false;
+		it->second->filled = true;
+	}
+}
+
+void WriteBuffer::wantFlush(BufferedPage &p, WriteBufferFlush reason)
+{
+	p.flush_wanted = true;
+	p.reason = reason;
+	flush_queue.push_back(p.page);
+}
+
+// returns false if the ftl had no room
+bool WriteBuffer::flush(list<BufferedPage>::iterator it)
+{
+	Ftl *ftl = parentNVDIMM->ftlFor(it->page);
+
+	// the flash can only program whole pages so get the rest of this one first
+	if (it->lines_dirty < lines_per_page && !it->filled && ftl->isMapped(it->page))
+	{
+		FlashTransaction fill = FlashTransaction(DATA_READ, it->page, NULL);
+		fill.origin = WRITE_BUFFER_ORIGIN;
+		if (!ftl->addTransaction(fill))
+		{
+			return false;
+		}
+		it->filling = true;
+		if (LOGGING)
+		{
+			log->write_buffer_fill();
+		}
+		return true;
+	}
+
+	FlashTransaction program = FlashTransaction(DATA_WRITE, it->page, NULL);
+	program.origin = WRITE_BUFFER_ORIGIN;
+	if (!ftl->addTransaction(program))
+	{
+		return false;
+	}
+	if (LOGGING)
+	{
+		log->write_buffer_flush(it->reason);
+	}
+	// reads that went to the flash while the page was here can come back with what the program is replacing
+	if (READ_CACHE)
+	{
+		parentNVDIMM->readCache->invalidate(it->page, NV_PAGE_SIZE);
+	}
+	where.erase(it->page);
+	pages.erase(it);
+
+	if (host_waiting)
+	{
+		host_waiting = false;
+		parentNVDIMM->readyToAccept();
+	}
+	return true;
+}
+
+void WriteBuffer::update(void)
+{
+	// pages are in the order they were first written so the old ones are all at the front
+	list<BufferedPage>::iterator it;
+	for (it = pages.begin(); it != pages.end() && currentClockCycle - it->first_write >= WRITE_BUFFER_MAX_AGE; it++)
+	{
+		if (!it->flush_wanted)
+		{
+			wantFlush(*it, AGED_FLUSH);
+		}
+	}
+
+	list<uint64_t>::iterator q = flush_queue.begin();
+	while (q != flush_queue.end())
+	{
+		list<BufferedPage>::iterator p = where[*q];
+		if (p->filling)
+		{
+			q++;
+			continue;
+		}
+		if (!flush(p))
+		{
+			break;
+		}
+		if (where.count(*q) == 0)
+		{
+			q = flush_queue.erase(q);
+		}
+		else
+		{
+			q++;
+		}
+	}
+
+	step();
+}
@@ -0,0 +1,108 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVWRITEBUFFER_H
+#define NVWRITEBUFFER_H
+
+//WriteBuffer.h
+//Write back DRAM buffer in front of the ftl that combines line sized host writes into pages, see WRITE_BUFFER
+//
+//Each host write covers one WRITE_BUFFER_LINE_SIZE line. Writes to a page that
+//is already buffered just mark their line, so rewrites and neighbouring lines
+//cost nothing extra on the flash. A page is flushed to the ftl as a single
+//program once every line in it has been written, once it has been sitting
+//there WRITE_BUFFER_MAX_AGE cycles, or when the buffer needs its spot for a
+//new page. A partial page that is already on the flash is read back before
+//it is flushed so the program has the whole page. Reads that only cover
+//lines that are in the buffer are answered from here.
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "SimObj.h"
+#include "FlashConfiguration.h"
+#include "FlashTransaction.h"
+#include "Logger.h"
+
+namespace NVDSim
+{
+	class NVDIMM;
+	class WriteBuffer : public SimObj
+	{
+	public:
+		WriteBuffer(NVDIMM *parent, Logger *l);
+
+		// false if the page isn't buffered and there isn't room for it yet
+		bool write(const FlashTransaction &trans);
+		// true if every line from offset to offset+size of the page is here so the read never has to go to the flash
+		bool forward(uint64_t page, uint64_t offset, uint64_t size);
+		// true if any of the page is buffered
+		bool holds(uint64_t page);
+		// the read of a partial page came back from the flash
+		void fillDone(uint64_t page);
+
+		void update(void);
+
+		// set when a write was turned away for lack of room
+		bool host_waiting;
+
+	private:
+		class BufferedPage
+		{
+		public:
+			uint64_t page;
+			std::vector<bool> dirty; // one per line
+			uint64_t lines_dirty;
+			uint64_t first_write;
+			bool flush_wanted;
+			bool filling; // waiting on the read of the rest of the page
+			bool filled; // the rest of the page has been read in
+			WriteBufferFlush reason;
+		};
+
+		void wantFlush(BufferedPage &p, WriteBufferFlush reason);
+		bool flush(std::list<BufferedPage>::iterator it);
+
+		NVDIMM *parentNVDIMM;
+		Logger *log;
+
+		uint64_t lines_per_page;
+		std::list<BufferedPage> pages; // in the order they were first written
+		std::unordered_map<uint64_t, std::list<BufferedPage>::iterator> where;
+		std::list<uint64_t> flush_queue; // pages waiting to go to the ftl
+	};
+}
+
+#endif
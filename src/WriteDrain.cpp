@@ -0,0 +1,169 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+//WriteDrain.cpp
+//Adaptive high and low watermarks for draining the write queues
+
+#include <cmath>
+
+#include "WriteDrain.h"
+#include "NVDIMM.h"
+
+using namespace NVDSim;
+using namespace std;
+
+// looking at every plane every cycle would cost more than the rest of the policy put together
+// so only look every so often, that still gives plenty of samples in a window
+#define DRAIN_SAMPLE_CYCLES 64
+
+WriteDrain::WriteDrain(NVDIMM *parent, Logger *l)
+{
+	parentNVDIMM = parent;
+	log = l;
+
+	max_high_watermark = DRAIN_HIGH_WATERMARK;
+	low_watermark = DRAIN_LOW_WATERMARK;
+	// start out holding the writes back like the static limits do until there is something to go on
+	pressure = 1.0;
+	high_watermark = max_high_watermark;
+
+	reads = 0;
+	writes = 0;
+	idle_planes = 0;
+	planes_sampled = 0;
+	currentClockCycle = 0;
+}
+
+bool WriteDrain::setWatermarks(double high, double low)
+{
+	if(low < 0.0 || high > 1.0 || low >= high)
+	{
+		WARNING("Write drain watermarks need 0 <= low < high <= 1, ignoring high "<<high<<" low "<<low);
+		return false;
+	}
+	max_high_watermark = high;
+	low_watermark = low;
+	high_watermark = low_watermark + (max_high_watermark - low_watermark) * pressure;
+	return true;
+}
+
+void WriteDrain::arrived(bool read)
+{
+	if(read)
+	{
+		reads++;
+	}
+	else
+	{
+		writes++;
+	}
+}
+
+bool WriteDrain::drain(bool draining, uint64_t size, uint64_t capacity)
+{
+	uint64_t low = (uint64_t)(low_watermark * capacity);
+	uint64_t high = (uint64_t)ceil(high_watermark * capacity);
+	// there always has to be at least one write between the two or we'd never stop
+	if(high <= low)
+	{
+		high = low + 1;
+	}
+
+	if(draining)
+	{
+		return size > low;
+	}
+	if(size >= high || (capacity != 0 && size >= capacity))
+	{
+		if(LOGGING)
+		{
+			log->write_drain_started();
+		}
+		return true;
+	}
+	return false;
+}
+
+void WriteDrain::update(void)
+{
+	if(currentClockCycle % DRAIN_SAMPLE_CYCLES == 0)
+	{
+		samplePlanes();
+	}
+	if(currentClockCycle != 0 && currentClockCycle % DRAIN_WINDOW == 0)
+	{
+		adjust();
+	}
+	step();
+}
+
+void WriteDrain::samplePlanes(void)
+{
+	for(uint64_t i = 0; i < NUM_PACKAGES; i++)
+	{
+		for(uint64_t j = 0; j < DIES_PER_PACKAGE; j++)
+		{
+			for(uint64_t k = 0; k < PLANES_PER_DIE; k++)
+			{
+				// 0 and 3 are both idle, they only differ in what is in the cache register
+				int busy = (*parentNVDIMM->packages)[i].dies[j]->isDieBusy(k);
+				if(busy == 0 || busy == 3)
+				{
+					idle_planes++;
+				}
+			}
+		}
+	}
+	planes_sampled += NUM_PACKAGES * DIES_PER_PACKAGE * PLANES_PER_DIE;
+}
+
+// the reads only need protecting when there are reads and the planes are busy enough that a write would hold them up
+void WriteDrain::adjust(void)
+{
+	double read_share = (reads + writes == 0) ? 0.0 : (double)reads / (double)(reads + writes);
+	double busy = (planes_sampled == 0) ? 0.0 : 1.0 - ((double)idle_planes / (double)planes_sampled);
+
+	// average with the last window so one odd window doesn't swing the watermarks all the way
+	pressure = (pressure + read_share * busy) / 2.0;
+	high_watermark = low_watermark + (max_high_watermark - low_watermark) * pressure;
+
+	if(LOGGING)
+	{
+		log->write_drain_window(high_watermark, low_watermark, pressure);
+	}
+
+	reads = 0;
+	writes = 0;
+	idle_planes = 0;
+	planes_sampled = 0;
+}
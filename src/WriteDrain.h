@@ -0,0 +1,91 @@
+/*********************************************************************************
+*  Copyright (c) 2011-2012, Paul Tschirhart
+*                             Peter Enns
+*                             Jim Stevens
+*                             Ishwar Bhati
+*                             Mu-Tien Chang
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             pkt3c [at] umd [dot] edu
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+#ifndef NVWRITEDRAIN_H
+#define NVWRITEDRAIN_H
+
+//WriteDrain.h
+//Adaptive high and low watermarks for draining the write queues, see ADAPTIVE_WRITE_DRAIN
+//
+//A write queue starts draining when it gets up to the high watermark and keeps
+//draining until it is down to the low watermark, the gap between the two keeps
+//a queue from flipping between reads and writes every cycle. The low watermark
+//is fixed but the high one moves every DRAIN_WINDOW cycles. When reads make up
+//most of what is arriving and the planes are busy the high watermark goes up
+//to DRAIN_HIGH_WATERMARK so the writes stay out of the way of the reads, when
+//the planes are idle or there are no reads to protect it comes down to the
+//low watermark so the writes go while they're cheap. Both watermarks are
+//fractions of the queue they are applied to so the ftl and the controller
+//queues share one policy.
+
+#include "SimObj.h"
+#include "FlashConfiguration.h"
+#include "Logger.h"
+
+namespace NVDSim
+{
+	class NVDIMM;
+	class WriteDrain : public SimObj
+	{
+	public:
+		WriteDrain(NVDIMM *parent, Logger *l);
+
+		// both are fractions of the queue, returns false and leaves them alone if they don't make sense
+		bool setWatermarks(double high, double low);
+
+		// called for each transaction that makes it into the nvdimm
+		void arrived(bool read);
+
+		// takes whether the queue was draining and returns whether it should be now
+		bool drain(bool draining, uint64_t size, uint64_t capacity);
+
+		void update(void);
+
+		double high_watermark; // where the high watermark is right now
+		double low_watermark;
+		double max_high_watermark;
+		double pressure; // 0 to 1, how much the reads need the writes to stay out of the way
+
+	private:
+		void samplePlanes(void);
+		void adjust(void);
+
+		NVDIMM *parentNVDIMM;
+		Logger *log;
+
+		uint64_t reads, writes;
+		uint64_t idle_planes, planes_sampled;
+	};
+}
+
+#endif
@@ -0,0 +1,101 @@
+#*********************************************************************************
+#  Copyright (c) 2011-2012, Paul Tschirhart
+#                             Jim Stevens
+#                             Peter Enns
+#                             Ishwar Bhati
+#                             Mu-Tien Chang
+#                             Bruce Jacob
+#                             University of Maryland 
+#                             pkt3c [at] umd [dot] edu
+#  All rights reserved.
+#  
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are met:
+#  
+#     * Redistributions of source code must retain the above copyright notice,
+#        this list of conditions and the following disclaimer.
+#  
+#     * Redistributions in binary form must reproduce the above copyright notice,
+#        this list of conditions and the following disclaimer in the documentation
+#        and/or other materials provided with the distribution.
+#  
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+#  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+#  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+#  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+#  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+#  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+#  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+#  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+#  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#********************************************************************************
+
+# Decodes the binary event trace (Events.bin) that NVDIMM writes when
+# BINARY_EVENT_LOG=1 into a csv with one row per event.
+#
+# usage: python decode_events.py Events.bin [out.csv]
+# if no output file is given the csv goes to stdout
+
+import sys
+import struct
+
+# must match EventRecord in EventLog.h
+RECORD_FORMAT = '<QQIHHHBBI'
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+MAGIC = 'NVDEVT01'
+
+EVENT_TYPES = ['ftl_read_queue', 'ftl_write_queue', 'ctrl_read_queue', 'ctrl_write_queue', 'plane_state']
+PLANE_STATES = ['IDLE', 'READING', 'GC_READING', 'WRITING', 'GC_WRITING', 'ERASING']
+TRANSACTION_TYPES = ['DATA_READ', 'DATA_WRITE', 'GC_DATA', 'GC_DATA_READ', 'GC_DATA_WRITE', 'RETURN_DATA', 'BLOCK_ERASE', 'EMPTY']
+PACKET_TYPES = ['READ', 'GC_READ', 'WRITE', 'GC_WRITE', 'ERASE', 'DATA', 'FAST_WRITE']
+
+def name(names, index):
+	if index < len(names):
+		return names[index]
+	return str(index)
+
+def decode(infile, outfile):
+	magic = infile.read(8)
+	if magic.decode('ascii', 'replace') != MAGIC:
+		sys.stderr.write('not an NVDIMM event log\n')
+		sys.exit(1)
+	record_size = struct.unpack('<Q', infile.read(8))[0]
+	if record_size != RECORD_SIZE:
+		sys.stderr.write('record size mismatch: file has '+str(record_size)+', decoder expects '+str(RECORD_SIZE)+'\n')
+		sys.exit(1)
+
+	outfile.write('cycle,event,address,package,die,plane,value,op\n')
+	while True:
+		data = infile.read(RECORD_SIZE)
+		if len(data) < RECORD_SIZE:
+			break
+		(cycle, address, value, package, die, plane, etype, op, reserved) = struct.unpack(RECORD_FORMAT, data)
+
+		if etype == 4:
+			# for plane events the value is the new state of the plane
+			value = name(PLANE_STATES, value)
+			op = ''
+		elif etype < 2:
+			op = name(TRANSACTION_TYPES, op)
+		else:
+			op = name(PACKET_TYPES, op)
+
+		outfile.write(','.join([str(cycle), name(EVENT_TYPES, etype), str(address), str(package), str(die), str(plane), str(value), op])+'\n')
+
+if __name__ == '__main__':
+	if len(sys.argv) < 2:
+		print('usage: python decode_events.py Events.bin [out.csv]')
+		sys.exit(1)
+
+	infile = open(sys.argv[1], 'rb')
+	if len(sys.argv) > 2:
+		outfile = open(sys.argv[2], 'w')
+	else:
+		outfile = sys.stdout
+
+	decode(infile, outfile)
+
+	infile.close()
+	if outfile != sys.stdout:
+		outfile.close()